@@ -7,6 +7,20 @@
 #include "led.h"
 #include "pwm.h"
 #include "buzzer.h"
+#include "audio.h"
+#include "lamp_fb.h"
+#include "evq.h"
+#include "sched.h"
+#include "flasher.h"
+#include "dim.h"
+#include "turn_ctrl.h"
+#include "input.h"
+#include "warning.h"
+#include "cycles.h"
+#include "adc.h"
+#include "persist.h"
+#include "speed.h"
+#include "systime.h"
 
 #define OFF 					0
 #define ON  					1
@@ -16,41 +30,332 @@
 #define HAZARD_INDICATOR		3
 #define SEATBELT_INDICATOR		4
 
-int main(void)
+#define EVT_BATCH				8U
+
+/* Turn/hazard arbitration, last press wins. Exactly one direction
+   reaches Indicator() and Buzzer() per pass */
+static void Turn_Update(void)
 {
-	int hazard_switch = 1;
-	int left_switch = 1;
-	int right_switch = 1;
-	int seatbelt_switch = 1;
+	uint8_t direction;
 
-  	PLL_Init();
-  	Timer_Init();
- 	SPI_Init();
-	LED_Init();
-	PWM_Init();
-	/* Ensure buzzer GPIO P2.11 is output for explicit OFF drive */
-	LPC_GPIO2->FIODIR |= (1 << 11);
-	while (1)
+	if (TurnCtrl_Tick() != 0U)
 	{
-		if (hazard_switch == ON)
-		{
-			Indicator(HAZARD_INDICATOR);
-			Buzzer(HAZARD_INDICATOR);
-		}
-		if (hazard_switch == OFF && left_switch == ON)
+		Sched_Kick(); /* latch the new frame now, not at the next timer event */
+	}
+
+	direction = (uint8_t)TurnCtrl_Owner();
+	Indicator(direction);
+	if (direction != (uint8_t)TURN_OWNER_IDLE)
+	{
+		Buzzer(direction);
+	}
+	else
+	{
+		Buzzer_Off(LEFT_INDICATOR);
+	}
+}
+
+/* Turn switch changes go to the arbiter with their edge time and are
+   arbitrated at once; other switches are read as levels where used */
+static void On_Input(const evt_t *e)
+{
+	static const turn_input_t turn_of[3] = { TURN_IN_LEFT, TURN_IN_RIGHT, TURN_IN_HAZARD };
+	uint8_t id = INPUT_EVT_ID(e->arg);
+
+	if ((e->id == (uint8_t)EVT_INPUT) && (id <= (uint8_t)INPUT_HAZARD))
+	{
+		(void)TurnCtrl_Set_Input(turn_of[id], INPUT_EVT_LEVEL(e->arg), e->time_us);
+		Turn_Update();
+	}
+}
+
+/* Hand every queued timer event to its consumers, a batch at a time */
+static void Dispatch_Events(void)
+{
+	evt_t batch[EVT_BATCH];
+	uint32_t n;
+	uint32_t i;
+
+	do
+	{
+		n = EvQ_Drain(&timer_evq, batch, EVT_BATCH);
+		for (i = 0U; i < n; i++)
 		{
-			Indicator(LEFT_INDICATOR);
-			Buzzer(LEFT_INDICATOR);
+			On_Input(&batch[i]);
+			Indicator_On_Event(&batch[i]);
+			Audio_On_Event(&batch[i]);
 		}
-		if (hazard_switch == OFF && right_switch == ON)
+	} while (n == EVT_BATCH);
+}
+
+/* CPU headroom and PWM1 interrupt rate over the last second,
+   for the debugger watch window */
+volatile uint16_t cpu_idle_permille = 0U;
+volatile uint32_t pwm1_irq_per_s = 0U;
+
+/* Worst turn lamp edge to tick sound skew over the last second */
+volatile uint32_t flasher_skew_max_us = 0U;
+
+/* Worst switch edge to first lamp frame latency over the last second */
+volatile uint32_t turn_latency_max_us = 0U;
+
+/* Worst Warning_Tick() cost in core cycles over the last second */
+volatile uint32_t warning_tick_cycles_max = 0U;
+static uint32_t warning_cycles_max = 0U;
+
+/* Vehicle speed and engine RPM, Q16.16, for the debugger watch window */
+volatile uint32_t speed_kmh_q16 = 0U;
+volatile uint32_t engine_rpm_q16 = 0U;
+
+/* No service interval source yet */
+static uint8_t service_due = 0U;
+
+/* Event task: runs after every timer tick event */
+static void Task_Events(void *ctx)
+{
+	(void)ctx;
+	Dispatch_Events();
+}
+
+/* 5 ms task: arbitration tick and indicator refresh */
+static void Task_Turn(void *ctx)
+{
+	(void)ctx;
+	Turn_Update();
+}
+
+/* Event task: apply pending ticks to the active outputs */
+static void Task_Cluster(void *ctx)
+{
+	(void)ctx;
+	/* Raised alongside the turn tick; the audio arbiter interleaves them */
+	if (Input_Level(INPUT_SEATBELT) != 0U)
+	{
+		Buzzer(SEATBELT_INDICATOR);
+	}
+	else
+	{
+		Buzzer_Off(SEATBELT_INDICATOR);
+	}
+}
+
+/* 5 ms task: filter the newest analog sender samples */
+static void Task_Adc(void *ctx)
+{
+	(void)ctx;
+	ADC_Update();
+}
+
+/* Fuel sender as Q16 percent, linear over the ADC range; full until the
+   first filtered value so the lamp cannot flash at power-up */
+static uint32_t Fuel_Pct_Q16(void)
+{
+	uint16_t raw;
+
+	if (ADC_Read(ADC_CH_FUEL, &raw) != ADC_STATUS_OK)
+	{
+		return WARNING_FUEL_FULL_Q16;
+	}
+	return (uint32_t)(((uint64_t)raw * WARNING_FUEL_FULL_Q16) / ADC_FULL_SCALE);
+}
+
+/* 5 ms task: seatbelt, service and low-fuel lamps */
+static void Task_Warning(void *ctx)
+{
+	warning_in_t in;
+	uint32_t t0;
+	uint32_t cycles;
+	uint8_t lamps;
+
+	(void)ctx;
+	in.seatbelt_buckled = (Input_Level(INPUT_SEATBELT) != 0U) ? 0U : 1U;
+	in.service_due = service_due;
+	in.fuel_pct_q16 = Fuel_Pct_Q16();
+
+	t0 = Cycles_Now();
+	lamps = Warning_Tick(&in);
+	cycles = Cycles_Now() - t0;
+	if (cycles > warning_cycles_max)
+	{
+		warning_cycles_max = cycles;
+	}
+
+	LED_Status(((lamps & WARNING_LAMP_SEATBELT) != 0U) ? SEATBELT_INDICATOR : OFF);
+	LampFB_Write(LAMPFB_BYTE_WARN, LAMPFB_WARN_SERVICE_MASK | LAMPFB_WARN_LOW_FUEL_MASK,
+		(uint8_t)((((lamps & WARNING_LAMP_SERVICE) != 0U) ? LAMPFB_WARN_SERVICE_MASK : 0U) |
+		          (((lamps & WARNING_LAMP_LOW_FUEL) != 0U) ? LAMPFB_WARN_LOW_FUEL_MASK : 0U)));
+}
+
+/* Latency and skew samples wait for the chain frame that carried the
+   change (numbered by LampFB) to latch */
+static uint8_t  lamps_last_turn = 0U;
+static uint8_t  lamps_mark_wait = 0U;
+static uint8_t  lamps_lat_wait = 0U;
+static uint32_t lamps_mark_seq;
+static uint32_t lamps_lat_seq;
+
+static void lamps_close_samples(void)
+{
+	uint64_t latched_us;
+
+	if ((lamps_mark_wait != 0U) && (LampFB_Latched(lamps_mark_seq, &latched_us) != 0U))
+	{
+		/* Turn lamp edge latched: skew probe against the tick sound */
+		Flasher_Mark_Lamp(latched_us);
+		lamps_mark_wait = 0U;
+	}
+	if ((lamps_lat_wait != 0U) && (LampFB_Latched(lamps_lat_seq, &latched_us) != 0U))
+	{
+		TurnCtrl_Output_Latched(latched_us);
+		lamps_lat_wait = 0U;
+	}
+}
+
+/* Event task: single update point for every lamp output */
+static void Task_Lamps(void *ctx)
+{
+	uint32_t seq = LampFB_Sent_Seq();
+
+	(void)ctx;
+	lamps_close_samples();
+	LampFB_Flush();
+	if (LampFB_Sent_Seq() != seq)
+	{
+		/* A frame only goes out once the previous one has latched */
+		lamps_close_samples();
+		seq = LampFB_Sent_Seq();
+		if (LampFB_Read_Out(LAMPFB_BYTE_TURN) != lamps_last_turn)
 		{
-			Indicator(RIGHT_INDICATOR);
-			Buzzer(RIGHT_INDICATOR);
+			lamps_last_turn = LampFB_Read_Out(LAMPFB_BYTE_TURN);
+			lamps_mark_seq  = seq;
+			lamps_mark_wait = 1U;
 		}
-		if (seatbelt_switch == ON)
+		if ((TurnCtrl_Latency_Pending() != 0U) && (lamps_lat_wait == 0U))
 		{
-			LED_Status(SEATBELT_INDICATOR);
-			Buzzer(SEATBELT_INDICATOR);
+			/* First frame since the owner change carries it */
+			lamps_lat_seq  = seq;
+			lamps_lat_wait = 1U;
 		}
 	}
+	else if ((lamps_lat_wait == 0U) && (LampFB_Pending() == 0U))
+	{
+		/* Nothing to send: the outputs already show the change */
+		TurnCtrl_Output_Latched(time_now_us());
+	}
+	else
+	{
+		/* Frame in flight or deferred: its latch kicks the next pass */
+	}
+}
+
+/* 20 ms task: day/night lamp brightness ramp */
+static void Task_Dim(void *ctx)
+{
+	uint64_t now_us = time_now_us();
+
+	(void)ctx;
+	Dim_Set_Night(Input_Level(INPUT_NIGHT), now_us);
+	Dim_Update(now_us);
+}
+
+/* 20 ms task: speed and RPM from the captured pulse edges; whole metres
+   travelled go to the odometer and trip, the remainder is kept */
+static void Task_Speed(void *ctx)
+{
+	static uint32_t last_pulses = 0U;
+	static uint32_t part_m = 0U;
+	speed_stats_t st;
+	uint32_t m;
+
+	(void)ctx;
+	Speed_Update();
+	speed_kmh_q16 = Speed_Kmh_Q16();
+	engine_rpm_q16 = Speed_Rpm_Q16();
+
+	(void)Speed_Get_Stats(SPEED_CH_VEHICLE, &st);
+	part_m += (st.pulses - last_pulses) * 1000U;
+	last_pulses = st.pulses;
+	m = part_m / SPEED_PULSES_PER_KM;
+	if (m != 0U)
+	{
+		part_m -= m * SPEED_PULSES_PER_KM;
+		(void)Persist_Add(PERSIST_ODOMETER_M, m);
+		(void)Persist_Add(PERSIST_TRIP_M, m);
+	}
+}
+
+/* 100 ms task: runtime minutes and wear-limited EEPROM saves. A stopped
+   vehicle is the quiet point for the flash store's sector erase */
+static void Task_Persist(void *ctx)
+{
+	(void)ctx;
+	Persist_Update(time_now_us());
+	if (Speed_Kmh_Q16() == 0U)
+	{
+		Persist_Maintain();
+	}
+}
+
+/* 1 s task: sample and restart the load measurements */
+static void Task_Monitor(void *ctx)
+{
+	static uint32_t last_pwm_irqs = 0U;
+	uint32_t pwm_irqs = PWM_Irq_Count();
+	flasher_skew_t skew;
+	turn_latency_t latency;
+
+	(void)ctx;
+	pwm1_irq_per_s = pwm_irqs - last_pwm_irqs;
+	last_pwm_irqs = pwm_irqs;
+	Flasher_Get_Skew(&skew);
+	flasher_skew_max_us = skew.max_us;
+	Flasher_Reset_Skew();
+	TurnCtrl_Get_Latency(&latency);
+	turn_latency_max_us = latency.max_us;
+	TurnCtrl_Reset_Latency();
+	warning_tick_cycles_max = warning_cycles_max;
+	warning_cycles_max = 0U;
+	cpu_idle_permille = Sched_Idle_Permille();
+	Sched_Reset_Stats();
+}
+
+int main(void)
+{
+  	PLL_Init();
+  	Timer_Init();
+ 	SPI_Init();
+	LED_Init();
+	LampFB_Init();
+	PWM_Init();
+	Audio_Init();
+	Flasher_Init();
+	Dim_Init();
+	TurnCtrl_Init();
+	Input_Init();
+	Warning_Init();
+	ADC_Init();
+	Persist_Init();
+	Speed_Init();
+	Cycles_Init();
+
+	/* Switches already on at power-up count as pressed now */
+	(void)TurnCtrl_Set_Input(TURN_IN_LEFT, Input_Level(INPUT_LEFT), time_now_us());
+	(void)TurnCtrl_Set_Input(TURN_IN_RIGHT, Input_Level(INPUT_RIGHT), time_now_us());
+	(void)TurnCtrl_Set_Input(TURN_IN_HAZARD, Input_Level(INPUT_HAZARD), time_now_us());
+
+	Sched_Init();
+	(void)Sched_Add(Task_Events,  NULL,    0U,   0U, 0U, NULL);
+	(void)Sched_Add(Task_Turn,    NULL, TURN_CTRL_TICK_MS, 0U, 1U, NULL);
+	(void)Sched_Add(Task_Cluster, NULL,    0U,   0U, 1U, NULL);
+	(void)Sched_Add(Task_Adc,     NULL, ADC_UPDATE_MS, 0U, 1U, NULL);
+	(void)Sched_Add(Task_Warning, NULL, WARNING_TICK_MS, 0U, 1U, NULL);
+	(void)Sched_Add(Task_Lamps,   NULL,    0U,   0U, 2U, NULL);
+	(void)Sched_Add(Task_Dim,     NULL, DIM_UPDATE_MS, 0U, 3U, NULL);
+	(void)Sched_Add(Task_Speed,   NULL, SPEED_UPDATE_MS, 0U, 3U, NULL);
+	(void)Sched_Add(Task_Persist, NULL, PERSIST_UPDATE_MS, 0U, 4U, NULL);
+	(void)Sched_Add(Task_Monitor, NULL, 1000U, 500U, SCHED_PRIO_LOWEST, NULL);
+
+	/* Never returns; sleeps whenever no task is runnable */
+	Sched_Run();
+	return 0;
 }
@@ -0,0 +1,186 @@
+/*
+ * File: adc.c
+ * Purpose: Burst-mode ADC into a self-linked GPDMA ring, batched decimation.
+ * Notes: Every AD0 input in SEL raises its own DMA request on completion
+ *        (ADGINTEN = 0, as burst mode requires), and the request stays up
+ *        until that input's DONE is cleared, which only a read of its own
+ *        AD0DRn does (an AD0GDR read leaves it set). So each request copies
+ *        AD0DRn: one linked-list item per burst round walks AD0DR0..2 with
+ *        source increment into the next ADC_CH_COUNT ring words, in the
+ *        order burst mode converts them. A word's channel is its ring
+ *        index modulo ADC_CH_COUNT.
+ *        The ring is only read here; its write position is the channel's
+ *        destination address. Words never written, and a register read
+ *        before its conversion completed, have DONE clear and are skipped,
+ *        so a pass right after start-up simply finds short windows.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "dma.h"
+#include "adc.h"
+
+#define ADC_CTRL          (DMA_CTRL_SBSIZE_1 | DMA_CTRL_DBSIZE_1 | \
+                           DMA_CTRL_SWIDTH_32BIT | DMA_CTRL_DWIDTH_32BIT | \
+                           DMA_CTRL_SI_MASK | DMA_CTRL_DI_MASK | (uint32_t)ADC_CH_COUNT)
+
+static volatile uint32_t adc_ring[ADC_RING_WORDS];
+static dma_lli_t         adc_lli[ADC_RING_ROUNDS];
+static uint16_t          adc_value[ADC_CH_COUNT];
+static uint8_t           adc_valid[ADC_CH_COUNT];
+static adc_stats_t       adc_stats;
+
+/* Per-channel window being gathered by one pass */
+typedef struct
+{
+    uint32_t sum;
+    uint16_t min;
+    uint16_t max;
+    uint8_t  n;
+} adc_acc_t;
+
+void ADC_Init(void)
+{
+    LPC_GPDMACH_TypeDef *ch = DMA_CHANNEL(DMA_CH_ADC);
+    uint32_t i;
+
+    /* 1) Power, clock from the plan, pins as analog inputs */
+    LPC_SC->PCONP    |= PCONP_PCADC_MASK;
+    LPC_SC->PCLKSEL0 &= ~PCLKSEL0_PCLK_ADC_MASK;
+    LPC_SC->PCLKSEL0 |=  PCLKSEL0_PCLK_ADC_PLAN;
+    LPC_PINCON->PINSEL1  = (LPC_PINCON->PINSEL1  & ~PINSEL1_ADC_MASK)  | PINSEL1_ADC_FUNC;
+    LPC_PINCON->PINMODE1 = (LPC_PINCON->PINMODE1 & ~PINMODE1_ADC_MASK) | PINMODE1_ADC_NOPULL;
+
+    for (i = 0U; i < ADC_RING_WORDS; i++)
+    {
+        adc_ring[i] = 0UL;
+    }
+    for (i = 0U; i < (uint32_t)ADC_CH_COUNT; i++)
+    {
+        adc_value[i] = 0U;
+        adc_valid[i] = 0U;
+    }
+    ADC_Reset_Stats();
+
+    /* 2) Ring: one item per burst round (AD0DR0..n into the next words),
+          the last linked back to the first */
+    DMA_Init();
+    for (i = 0U; i < ADC_RING_ROUNDS; i++)
+    {
+        adc_lli[i].src     = (uint32_t)&LPC_ADC->DR[0];
+        adc_lli[i].dst     = (uint32_t)&adc_ring[i * (uint32_t)ADC_CH_COUNT];
+        adc_lli[i].next    = (uint32_t)&adc_lli[(i + 1U) % ADC_RING_ROUNDS];
+        adc_lli[i].control = ADC_CTRL;
+    }
+
+    ch->CConfig   = 0UL;
+    LPC_GPDMA->IntTCClear = (1UL << DMA_CH_ADC);
+    LPC_GPDMA->IntErrClr  = (1UL << DMA_CH_ADC);
+    ch->CSrcAddr  = adc_lli[0].src;
+    ch->CDestAddr = adc_lli[0].dst;
+    ch->CLLI      = adc_lli[0].next;
+    ch->CControl  = adc_lli[0].control;
+    ch->CConfig   = DMA_CCFG_SRCPERIPH(DMA_PERIPH_ADC) | DMA_CCFG_TT_P2M | DMA_CCFG_E_MASK;
+
+    /* 3) Per-channel DMA requests, then start burst conversions */
+    LPC_ADC->INTEN = ADC_CR_SEL_MASK;
+    LPC_ADC->CR    = ADC_CR_SEL_MASK | ADC_CR_CLKDIV(ADC_CLKDIV) | ADC_CR_PDN_MASK | ADC_CR_BURST_MASK;
+}
+
+void ADC_Update(void)
+{
+    adc_acc_t acc[ADC_CH_COUNT];
+    uint32_t  pos;
+    uint32_t  scanned;
+    uint8_t   need = (uint8_t)ADC_CH_COUNT;
+    uint8_t   c;
+
+    for (c = 0U; c < (uint8_t)ADC_CH_COUNT; c++)
+    {
+        acc[c].sum = 0U;
+        acc[c].min = 0xFFFFU;
+        acc[c].max = 0U;
+        acc[c].n   = 0U;
+    }
+
+    /* Next word the DMA will write; everything before it is complete */
+    pos = (DMA_CHANNEL(DMA_CH_ADC)->CDestAddr - (uint32_t)&adc_ring[0]) / 4U;
+    if (pos >= ADC_RING_WORDS)
+    {
+        pos = 0U;
+    }
+
+    for (scanned = 0U; (scanned < ADC_SCAN_WORDS) && (need != 0U); scanned++)
+    {
+        uint32_t  w;
+        uint16_t  v;
+        adc_acc_t *a;
+
+        pos = (pos == 0U) ? (ADC_RING_WORDS - 1U) : (pos - 1U);
+        w   = adc_ring[pos];
+        if ((w & ADC_DR_DONE_MASK) == 0UL)
+        {
+            continue;   /* not written since start-up, or read early */
+        }
+        c = (uint8_t)(pos % (uint32_t)ADC_CH_COUNT);
+        a = &acc[c];
+        if (a->n >= ADC_WINDOW)
+        {
+            continue;
+        }
+
+        v = (uint16_t)ADC_DR_RESULT(w);
+        a->sum += v;
+        if (v < a->min) { a->min = v; }
+        if (v > a->max) { a->max = v; }
+        a->n++;
+        if (a->n == ADC_WINDOW)
+        {
+            need--;
+        }
+    }
+
+    /* Drop both extremes, 16 samples remain: sum >> 2 is 14 bits */
+    for (c = 0U; c < (uint8_t)ADC_CH_COUNT; c++)
+    {
+        if (acc[c].n == ADC_WINDOW)
+        {
+            adc_value[c] = (uint16_t)((acc[c].sum - acc[c].min - acc[c].max) >> 2);
+            adc_valid[c] = 1U;
+        }
+        else
+        {
+            adc_stats.short_windows++;
+        }
+    }
+    adc_stats.passes++;
+}
+
+adc_status_t ADC_Read(adc_channel_t ch, uint16_t *value)
+{
+    if (((uint32_t)ch >= (uint32_t)ADC_CH_COUNT) || (value == NULL))
+    {
+        return ADC_STATUS_INVALID_PARAM;
+    }
+    if (adc_valid[ch] == 0U)
+    {
+        return ADC_STATUS_NO_DATA;
+    }
+    *value = adc_value[ch];
+    return ADC_STATUS_OK;
+}
+
+void ADC_Get_Stats(adc_stats_t *out)
+{
+    if (out != NULL)
+    {
+        *out = adc_stats;
+    }
+}
+
+void ADC_Reset_Stats(void)
+{
+    adc_stats.passes        = 0U;
+    adc_stats.short_windows = 0U;
+}
@@ -0,0 +1,110 @@
+/*
+ * File: adc.h
+ * Purpose: Analog sender acquisition: ADC burst mode into a GPDMA ring (MISRA C:2012 aligned)
+ *
+ * The ADC converts the configured inputs round-robin in burst mode, with
+ * no CPU involvement. GPDMA copies every result from its channel's data
+ * register (the read that clears the channel's DMA request) into a
+ * circular ring that links to itself, so acquisition never stops and never
+ * interrupts. The ring is interleaved: word i holds channel i % ADC_CH_COUNT.
+ *
+ * ADC_Update() is one batched pass per tick: it walks the ring backwards
+ * from the DMA write position, takes the newest ADC_WINDOW samples of every
+ * channel, drops the smallest and the largest (spike rejection) and
+ * decimates the other 16 to one 14-bit value (16x oversampling, +2 bits).
+ * Consumers read the latest values and never wait on a conversion.
+ */
+
+#ifndef ADC_H
+#define ADC_H
+
+#include <stdint.h>
+#include "clock_plan.h"
+
+/* Status codes for ADC APIs */
+typedef enum
+{
+    ADC_STATUS_OK = 0,
+    ADC_STATUS_INVALID_PARAM = 1,
+    ADC_STATUS_NO_DATA = 2
+} adc_status_t;
+
+/* Sender channels; the value is the AD0 input */
+typedef enum
+{
+    ADC_CH_FUEL = 0,        /* AD0.0, P0.23 */
+    ADC_CH_COOLANT = 1,     /* AD0.1, P0.24 */
+    ADC_CH_BATTERY = 2,     /* AD0.2, P0.25 */
+    ADC_CH_COUNT = 3
+} adc_channel_t;
+
+/* Power/clock: PCONP bit 12, PCLKSEL0 bits [25:24] */
+#define PCONP_PCADC_MASK                  (1UL << 12)
+#define PCLKSEL0_PCLK_ADC_MASK            (3UL << 24)
+#define PCLKSEL0_PCLK_ADC_PLAN            (CLOCK_PLAN_PCLKSEL_BITS << 24)
+
+/* P0.23..P0.25 as AD0.0..AD0.2 (PINSEL1 = 01), no pull (PINMODE1 = 10) */
+#define PINSEL1_ADC_MASK                  ((3UL << 14) | (3UL << 16) | (3UL << 18))
+#define PINSEL1_ADC_FUNC                  ((1UL << 14) | (1UL << 16) | (1UL << 18))
+#define PINMODE1_ADC_MASK                 ((3UL << 14) | (3UL << 16) | (3UL << 18))
+#define PINMODE1_ADC_NOPULL               ((2UL << 14) | (2UL << 16) | (2UL << 18))
+
+/* AD0CR fields; START must stay 000 in burst mode */
+#define ADC_CR_SEL_MASK                   ((1UL << ADC_CH_COUNT) - 1UL)
+#define ADC_CR_CLKDIV(d)                  ((uint32_t)(d) << 8)
+#define ADC_CR_BURST_MASK                 (1UL << 16)
+#define ADC_CR_PDN_MASK                   (1UL << 21)
+
+/* AD0DRn fields */
+#define ADC_DR_RESULT(w)                  (((w) >> 4) & 0xFFFUL)
+#define ADC_DR_DONE_MASK                  (1UL << 31)
+
+/* ADC clock: at most 13 MHz; one conversion takes 65 clocks */
+#ifndef ADC_CLK_HZ
+#define ADC_CLK_HZ                        (1000000UL)
+#endif
+#define ADC_CLKDIV                        (((CLOCK_PLAN_PCLK_HZ + ADC_CLK_HZ - 1UL) / ADC_CLK_HZ) - 1UL)
+#define ADC_SAMPLE_HZ                     ((CLOCK_PLAN_PCLK_HZ / (ADC_CLKDIV + 1UL)) / 65UL)
+
+#if ((CLOCK_PLAN_PCLK_HZ / (ADC_CLKDIV + 1UL)) > 13000000UL)
+#error "adc: ADC clock exceeds 13 MHz"
+#endif
+#if (ADC_CLKDIV > 255UL)
+#error "adc: ADC clock too slow for CLKDIV"
+#endif
+
+/* Pass period */
+#define ADC_UPDATE_MS                     (5U)
+
+/* Samples per channel per pass: the extremes are dropped, 16 are averaged */
+#define ADC_WINDOW                        (18U)
+#define ADC_FULL_SCALE                    (16380U)   /* 16 * 4095 >> 2 */
+
+/* DMA ring (one linked-list item per burst round); a pass scans at most
+   ADC_SCAN_WORDS back, the rest is margin for results that land while it runs */
+#define ADC_RING_ROUNDS                   (42U)
+#define ADC_RING_WORDS                    (ADC_RING_ROUNDS * (uint32_t)ADC_CH_COUNT)
+#define ADC_SCAN_WORDS                    (96U)
+
+#if ((ADC_WINDOW * ADC_CH_COUNT) > ADC_SCAN_WORDS)
+#error "adc: scan window cannot hold a full window of every channel"
+#endif
+
+/* Pass statistics since the last reset */
+typedef struct
+{
+    uint32_t passes;
+    uint32_t short_windows;   /* channel had fewer than ADC_WINDOW samples */
+} adc_stats_t;
+
+/* Public API (main context) */
+/* Start burst conversions and the DMA ring */
+void         ADC_Init(void);
+/* Batched filter pass over the newest ring entries; call every ADC_UPDATE_MS */
+void         ADC_Update(void);
+/* Latest filtered value, 0..ADC_FULL_SCALE; NO_DATA until the first full window */
+adc_status_t ADC_Read(adc_channel_t ch, uint16_t *value);
+void         ADC_Get_Stats(adc_stats_t *out);
+void         ADC_Reset_Stats(void);
+
+#endif /* ADC_H */
@@ -0,0 +1,140 @@
+/*
+ * File: anim.c
+ * Purpose: Generic frame-table player over the lamp framebuffer.
+ * Notes: Phase comes from timestamps: anchor_us is the first tick after
+ *        play, derived from whichever tick is seen first. The frame due is
+ *        then a division, so a stall of any length costs no phase.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "evq.h"
+#include "lamp_fb.h"
+#include "timer.h"
+#include "anim.h"
+
+static const uint8_t anim_left_fill[] =
+{
+    0U, ANIM_RUN(3U, 3U), ANIM_RUN(2U, 3U), ANIM_RUN(1U, 3U), ANIM_RUN(0U, 3U)
+};
+
+static const uint8_t anim_right_fill[] =
+{
+    0U, ANIM_RUN(4U, 4U), ANIM_RUN(4U, 5U), ANIM_RUN(4U, 6U), ANIM_RUN(4U, 7U)
+};
+
+static const uint8_t anim_center_out[] =
+{
+    0U, ANIM_RUN(3U, 4U), ANIM_RUN(2U, 5U), ANIM_RUN(1U, 6U), ANIM_RUN(0U, 7U)
+};
+
+static const uint8_t anim_sweep[] =
+{
+    ANIM_BIT(0U), ANIM_BIT(1U), ANIM_BIT(2U), ANIM_BIT(3U),
+    ANIM_BIT(4U), ANIM_BIT(5U), ANIM_BIT(6U), ANIM_BIT(7U),
+    ANIM_BIT(6U), ANIM_BIT(5U), ANIM_BIT(4U), ANIM_BIT(3U),
+    ANIM_BIT(2U), ANIM_BIT(1U)
+};
+
+static const uint8_t anim_chase[] =
+{
+    ANIM_RUN(0U, 1U), ANIM_RUN(1U, 2U), ANIM_RUN(2U, 3U), ANIM_RUN(3U, 4U),
+    ANIM_RUN(4U, 5U), ANIM_RUN(5U, 6U), ANIM_RUN(6U, 7U),
+    (uint8_t)(ANIM_BIT(7U) | ANIM_BIT(0U))
+};
+
+static const uint8_t anim_hazard[] =
+{
+    ANIM_ALL, 0U
+};
+
+#define ANIM_FRAMES(tbl)                  (tbl), (uint8_t)(sizeof(tbl) / sizeof((tbl)[0]))
+
+#define ANIM_LED1                         (uint8_t)EVT_LED1_TICK, (uint16_t)TIMER_LED1_PERIOD_MS
+#define ANIM_LED2                         (uint8_t)EVT_LED2_TICK, (uint16_t)TIMER_LED2_PERIOD_MS
+
+const anim_t Anim_Left_Fill  = { ANIM_FRAMES(anim_left_fill),  ANIM_LED1 };
+const anim_t Anim_Right_Fill = { ANIM_FRAMES(anim_right_fill), ANIM_LED2 };
+const anim_t Anim_Center_Out = { ANIM_FRAMES(anim_center_out), ANIM_LED1 };
+const anim_t Anim_Sweep      = { ANIM_FRAMES(anim_sweep),      ANIM_LED2 };
+const anim_t Anim_Chase      = { ANIM_FRAMES(anim_chase),      ANIM_LED2 };
+const anim_t Anim_Hazard     = { ANIM_FRAMES(anim_hazard),     ANIM_LED1 };
+
+void Anim_Init(anim_player_t *p, uint8_t fb_index)
+{
+    p->anim     = NULL;
+    p->anchored = 0U;
+    p->frame    = 0U;
+    p->fb_index = fb_index;
+}
+
+void Anim_Play(anim_player_t *p, const anim_t *a, uint64_t now_us)
+{
+    if ((a == NULL) || (a->count == 0U) || (a->step_ms == 0U) || (a == p->anim))
+    {
+        return;
+    }
+
+    p->anim     = a;
+    p->play_us  = now_us;
+    p->anchored = 0U;
+    p->frame    = 0U;
+    LampFB_Write(p->fb_index, 0xFFU, a->frames[0]);
+}
+
+void Anim_Stop(anim_player_t *p)
+{
+    p->anim = NULL;
+}
+
+void Anim_Lock(anim_player_t *p, uint64_t first_step_us)
+{
+    if (p->anim != NULL)
+    {
+        p->anchor_us = first_step_us;
+        p->anchored  = 1U;
+    }
+}
+
+void Anim_On_Event(anim_player_t *p, const evt_t *e)
+{
+    const anim_t *a = p->anim;
+
+    if (a == NULL)
+    {
+        return;
+    }
+
+    /* Ticks are exactly step_ms apart, so any one after play_us (even if
+       earlier ones were dropped) tells where the first one was. The slack
+       keeps ISR latency on the stamp from counting as an extra step */
+    if ((p->anchored == 0U) && (e->id == a->tick) && (e->time_us > (p->play_us + ANIM_SLACK_US)))
+    {
+        uint64_t step_us = (uint64_t)a->step_ms * 1000U;
+        uint64_t missed  = (e->time_us - ANIM_SLACK_US - p->play_us - 1U) / step_us;
+
+        p->anchor_us = e->time_us - (missed * step_us);
+        p->anchored  = 1U;
+    }
+}
+
+void Anim_Update(anim_player_t *p, uint64_t now_us)
+{
+    const anim_t *a = p->anim;
+    uint64_t      due;
+    uint8_t       frame;
+
+    if ((a == NULL) || (p->anchored == 0U) || ((now_us + ANIM_SLACK_US) < p->anchor_us))
+    {
+        return;
+    }
+
+    /* Frame 1 at the first tick, one more per step_ms after it */
+    due   = 1U + ((now_us + ANIM_SLACK_US - p->anchor_us) / ((uint64_t)a->step_ms * 1000U));
+    frame = (uint8_t)(due % a->count);
+    if (frame != p->frame)
+    {
+        p->frame = frame;
+        LampFB_Write(p->fb_index, 0xFFU, a->frames[frame]);
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ * File: anim.h
+ * Purpose: Keyframe-table lamp animations (MISRA C:2012 aligned)
+ *
+ * An animation is a const table of lamp frames plus the tick that paces it
+ * (event id and period). One generic player shows any table, so each step
+ * is a single table read and one framebuffer write; a new pattern costs
+ * only flash. Frames are built at compile time from the ANIM_* macros.
+ *
+ * The frame shown is computed from elapsed time, not counted per event:
+ * any tick timestamp fixes the phase of the tick timeline, and the frame
+ * due at "now" follows from it. A stall (flash write, long init, dropped
+ * events) therefore lands straight back on the correct frame.
+ */
+
+#ifndef ANIM_H
+#define ANIM_H
+
+#include <stdint.h>
+#include "evq.h"
+
+/* Compile-time frame builders (bit 0..7 of one lamp byte) */
+#define ANIM_BIT(n)                       ((uint8_t)(1U << (n)))
+#define ANIM_RUN(lo, hi)                  ((uint8_t)((0xFFU << (lo)) & (0xFFU >> (7U - (hi)))))
+#define ANIM_ALL                          ANIM_RUN(0U, 7U)
+
+/* Tolerance for ISR latency jitter between tick timestamps */
+#define ANIM_SLACK_US                     (100U)
+
+typedef struct
+{
+    const uint8_t *frames;
+    uint8_t        count;
+    uint8_t        tick;     /* evt_id_t that paces the frames */
+    uint16_t       step_ms;  /* period of that tick */
+} anim_t;
+
+/* Playback cursor bound to one framebuffer byte */
+typedef struct
+{
+    const anim_t *anim;      /* NULL => stopped, output left as-is */
+    uint64_t      play_us;   /* when frame 0 was shown */
+    uint64_t      anchor_us; /* first tick after play_us, once known */
+    uint8_t       anchored;
+    uint8_t       frame;
+    uint8_t       fb_index;  /* LampFB byte written */
+} anim_player_t;
+
+/* Built-in animations */
+extern const anim_t Anim_Left_Fill;    /* bits 3 -> 0, LED1 pace */
+extern const anim_t Anim_Right_Fill;   /* bits 4 -> 7, LED2 pace */
+extern const anim_t Anim_Center_Out;   /* 3&4 -> 0&7, LED1 pace */
+extern const anim_t Anim_Sweep;        /* one lamp 0 -> 7 -> 0, LED2 pace */
+extern const anim_t Anim_Chase;        /* lamp pair walking up, LED2 pace */
+extern const anim_t Anim_Hazard;       /* all on / all off, LED1 pace */
+
+/* Public API */
+/* Bind p to a framebuffer byte, stopped */
+void Anim_Init(anim_player_t *p, uint8_t fb_index);
+/* Show frame 0 of a at now_us and play it; no effect if a is already playing */
+void Anim_Play(anim_player_t *p, const anim_t *a, uint64_t now_us);
+void Anim_Stop(anim_player_t *p);
+/* Pin the phase instead of learning it from ticks: the first step after
+   play is at first_step_us (used to lock frames to the flasher beat) */
+void Anim_Lock(anim_player_t *p, uint64_t first_step_us);
+/* Learn the tick phase from e if it is the animation's tick */
+void Anim_On_Event(anim_player_t *p, const evt_t *e);
+/* Show the frame due at now_us; call with the current time, not an event
+   stamp, so a drained backlog cannot step the output backwards */
+void Anim_Update(anim_player_t *p, uint64_t now_us);
+
+#endif /* ANIM_H */
@@ -0,0 +1,134 @@
+/*
+ * File: audio.c
+ * Purpose: Per-client chime players with one arbitrated buzzer output.
+ * Notes: Runs in main context (event dispatch and tasks), so no locking is
+ *        needed. Raising a new chime or releasing one arbitrates at once;
+ *        otherwise ownership changes only on the buzzer tick. Players
+ *        follow time_now_us(), so a stall does not shift a chime.
+ *        RAM is one request slot per client, independent of chime count.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "evq.h"
+#include "systime.h"
+#include "chime.h"
+#include "flasher.h"
+#include "audio.h"
+
+typedef struct
+{
+    const chime_t  *chime;      /* NULL => not raised */
+    uint8_t         prio;
+    chime_player_t  player;     /* own timeline, runs even while not heard */
+} audio_req_t;
+
+static audio_req_t         audio_reqs[AUDIO_CLIENT_COUNT];
+static uint8_t             audio_owner = AUDIO_NO_OWNER;
+static const chime_step_t *audio_out   = NULL;   /* step last driven */
+
+static uint8_t audio_audible(const chime_step_t *s)
+{
+    return ((s != NULL) && (s->tone_hz != 0U) && (s->duty_permille != 0U)) ? 1U : 0U;
+}
+
+static void audio_arbitrate(void)
+{
+    const chime_step_t *out   = NULL;
+    uint8_t             owner = AUDIO_NO_OWNER;
+    uint8_t             i;
+
+    for (i = 0U; i < (uint8_t)AUDIO_CLIENT_COUNT; i++)
+    {
+        const chime_step_t *s = Chime_Player_Step(&audio_reqs[i].player);
+
+        if ((audio_reqs[i].chime != NULL) && (audio_audible(s) != 0U) &&
+            ((owner == AUDIO_NO_OWNER) || (audio_reqs[i].prio < audio_reqs[owner].prio)))
+        {
+            owner = i;
+            out   = s;
+        }
+    }
+
+    audio_owner = owner;
+    if (out != audio_out)
+    {
+        audio_out = out;
+        Chime_Output(out);
+        if ((out != NULL) && (audio_reqs[owner].chime->beat_locked != 0U))
+        {
+            Flasher_Mark_Sound(time_now_us()); /* tick started: skew probe */
+        }
+    }
+}
+
+void Audio_Init(void)
+{
+    uint8_t i;
+
+    for (i = 0U; i < (uint8_t)AUDIO_CLIENT_COUNT; i++)
+    {
+        audio_reqs[i].chime = NULL;
+        Chime_Player_Start(&audio_reqs[i].player, NULL, 0U);
+    }
+    audio_owner = AUDIO_NO_OWNER;
+    audio_out   = NULL;
+    Chime_Output(NULL);
+}
+
+audio_status_t Audio_Request(audio_client_t client, const chime_t *c, uint8_t prio)
+{
+    audio_req_t *r;
+
+    if (((uint32_t)client >= (uint32_t)AUDIO_CLIENT_COUNT) || (c == NULL))
+    {
+        return AUDIO_STATUS_INVALID_PARAM;
+    }
+
+    r = &audio_reqs[client];
+    r->prio = prio;
+    if (r->chime != c)
+    {
+        r->chime = c;
+        Chime_Player_Start(&r->player, c, time_now_us());
+        audio_arbitrate(); /* first step starts now, not at the next tick */
+    }
+    return AUDIO_STATUS_OK;
+}
+
+void Audio_Release(audio_client_t client)
+{
+    if (((uint32_t)client < (uint32_t)AUDIO_CLIENT_COUNT) && (audio_reqs[client].chime != NULL))
+    {
+        audio_reqs[client].chime = NULL;
+        Chime_Player_Start(&audio_reqs[client].player, NULL, 0U);
+        audio_arbitrate();
+    }
+}
+
+void Audio_On_Event(const evt_t *e)
+{
+    uint64_t now_us;
+    uint8_t  i;
+
+    if ((e->id != (uint8_t)EVT_BUZZER_TICK) && (e->id != (uint8_t)EVT_FLASH_BEAT))
+    {
+        return;
+    }
+
+    /* The tick only prompts a re-evaluation; the step comes from the
+       current time, so a backlog of ticks after a stall jumps straight to
+       the due step instead of replaying old ones on the buzzer. The beat
+       event makes beat-locked chimes click in the pass the lamps step */
+    now_us = time_now_us();
+    for (i = 0U; i < (uint8_t)AUDIO_CLIENT_COUNT; i++)
+    {
+        (void)Chime_Player_Update(&audio_reqs[i].player, now_us);
+    }
+    audio_arbitrate();
+}
+
+uint8_t Audio_Owner(void)
+{
+    return audio_owner;
+}
@@ -0,0 +1,56 @@
+/*
+ * File: audio.h
+ * Purpose: Priority arbitration of buzzer requests (MISRA C:2012 aligned)
+ *
+ * Clients raise a request (chime + priority, 0 = most urgent) and clear it;
+ * raising the same chime again is free, so callers may raise every pass.
+ * Every raised request keeps its own player running on each buzzer tick,
+ * and once per tick (and on a new request or a release) one owner is chosen:
+ *   - the most urgent request whose current step is audible owns the
+ *     buzzer, so a higher-priority tone preempts a lower one;
+ *   - while the higher request is in a silent step, the lower one is heard
+ *     again, in its own rhythm (interleaving, then resume);
+ *   - equal priorities go to the lower client id.
+ * The buzzer is driven only when the winning step changes.
+ */
+
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <stdint.h>
+#include "evq.h"
+#include "chime.h"
+
+/* Status codes for audio APIs */
+typedef enum
+{
+    AUDIO_STATUS_OK = 0,
+    AUDIO_STATUS_INVALID_PARAM = 1
+} audio_status_t;
+
+/* Request owners; each holds at most one chime at a time */
+typedef enum
+{
+    AUDIO_CLIENT_TURN = 0,      /* turn and hazard tick */
+    AUDIO_CLIENT_SEATBELT = 1,
+    AUDIO_CLIENT_COUNT
+} audio_client_t;
+
+/* Default priorities: the seatbelt chime preempts the turn tick */
+#define AUDIO_PRIO_SEATBELT               (1U)
+#define AUDIO_PRIO_TURN                   (2U)
+
+#define AUDIO_NO_OWNER                    (0xFFU)
+
+/* Public API */
+void           Audio_Init(void);
+/* Raise or update; a different chime restarts that client's player.
+   A finished non-looping chime stays finished until released */
+audio_status_t Audio_Request(audio_client_t client, const chime_t *c, uint8_t prio);
+void           Audio_Release(audio_client_t client);
+/* Advance all players and arbitrate on EVT_BUZZER_TICK */
+void           Audio_On_Event(const evt_t *e);
+/* Client heard during the last tick, or AUDIO_NO_OWNER */
+uint8_t        Audio_Owner(void);
+
+#endif /* AUDIO_H */
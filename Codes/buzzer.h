@@ -1,2 +1,5 @@
 #include <stdint.h>
+/* Raise the chime for a direction (1/2 turn, 3 hazard, 4 seatbelt), any other value clears all */
 void Buzzer(uint8_t direction);
+/* Clear the chime raised for a direction */
+void Buzzer_Off(uint8_t direction);
@@ -0,0 +1,130 @@
+/*
+ * File: chime.c
+ * Purpose: Step sequencing over const chime tables.
+ * Notes: A player only moves a cursor, recomputed from elapsed time on each
+ *        update, so there is no per-tick state to fall behind.
+ *        Chime_Output() is the single place
+ *        the buzzer is driven, and PWM_Buzzer_Set/Enable skip unchanged
+ *        registers.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "clock_plan.h"
+#include "pwm.h"
+#include "flasher.h"
+#include "chime.h"
+
+/* Tone used by every built-in chime */
+#define CHIME_TONE_HZ                     ((uint16_t)PWM1_TONE_HZ)
+
+static const chime_step_t chime_turn_steps[] =
+{
+    { CHIME_TONE_HZ, 500U,   40U },
+    { 0U,              0U,  320U }
+};
+
+static const chime_step_t chime_hazard_steps[] =
+{
+    { CHIME_TONE_HZ, 133U,   20U },
+    { 0U,              0U, 2000U }
+};
+
+static const chime_step_t chime_seatbelt_steps[] =
+{
+    { CHIME_TONE_HZ, 933U,  200U },
+    { 0U,              0U,  800U }
+};
+
+#define CHIME_STEPS(tbl)                  (tbl), (uint8_t)(sizeof(tbl) / sizeof((tbl)[0]))
+
+/* The off step of the beat-locked chimes only matters while no flasher
+   runs; otherwise the next beat cuts it short */
+const chime_t Chime_Turn     = { CHIME_STEPS(chime_turn_steps),     CHIME_LOOP_FOREVER, 1U };
+const chime_t Chime_Hazard   = { CHIME_STEPS(chime_hazard_steps),   CHIME_LOOP_FOREVER, 1U };
+const chime_t Chime_Seatbelt = { CHIME_STEPS(chime_seatbelt_steps), CHIME_LOOP_FOREVER, 0U };
+
+void Chime_Player_Start(chime_player_t *p, const chime_t *c, uint64_t now_us)
+{
+    p->chime    = ((c != NULL) && (c->count != 0U)) ? c : NULL;
+    p->start_us = now_us;
+    p->step     = 0U;
+}
+
+uint8_t Chime_Player_Update(chime_player_t *p, uint64_t now_us)
+{
+    const chime_t *c = p->chime;
+    uint32_t       cycle_ms = 0U;
+    uint64_t       elapsed_ms;
+    uint32_t       pos_ms;
+    uint8_t        i;
+
+    if (c == NULL)
+    {
+        return 0U;
+    }
+    if ((now_us + CHIME_SLACK_US) < p->start_us)
+    {
+        return 1U;
+    }
+
+    for (i = 0U; i < c->count; i++)
+    {
+        cycle_ms += c->steps[i].duration_ms;
+    }
+    if (cycle_ms == 0U)
+    {
+        p->chime = NULL;
+        return 0U;
+    }
+
+    if ((c->beat_locked != 0U) && (Flasher_Running() != 0U))
+    {
+        /* Position within the current beat; hold the last step past the cycle */
+        uint64_t t = now_us + CHIME_SLACK_US;
+
+        elapsed_ms = (t - Flasher_Beat_Start_Us(t)) / 1000U;
+        pos_ms     = (elapsed_ms >= cycle_ms) ? (cycle_ms - 1U) : (uint32_t)elapsed_ms;
+    }
+    else
+    {
+        elapsed_ms = (now_us + CHIME_SLACK_US - p->start_us) / 1000U;
+        if ((c->loops != CHIME_LOOP_FOREVER) && (elapsed_ms >= ((uint64_t)cycle_ms * c->loops)))
+        {
+            p->chime = NULL;
+            return 0U;
+        }
+        pos_ms = (uint32_t)(elapsed_ms % cycle_ms);
+    }
+
+    /* Walk the (short) step list to the position */
+    i = 0U;
+    while (pos_ms >= c->steps[i].duration_ms)
+    {
+        pos_ms -= c->steps[i].duration_ms;
+        i++;
+    }
+    p->step = i;
+    return 1U;
+}
+
+const chime_step_t *Chime_Player_Step(const chime_player_t *p)
+{
+    return (p->chime != NULL) ? &p->chime->steps[p->step] : NULL;
+}
+
+void Chime_Output(const chime_step_t *s)
+{
+    if ((s == NULL) || (s->tone_hz == 0U) || (s->duty_permille == 0U))
+    {
+        PWM_Buzzer_Enable(0U);
+    }
+    else
+    {
+        uint32_t period = CLOCK_PLAN_PWM1_TICKS((uint32_t)s->tone_hz);
+        /* Nearest tick: 133 and 933 permille of 1500 give the old 200 and
+           1400 (2/15, 14/15), where truncation gave 199 and 1399 */
+        PWM_Buzzer_Set(period, ((period * s->duty_permille) + 500U) / 1000U);
+        PWM_Buzzer_Enable(1U);
+    }
+}
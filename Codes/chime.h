@@ -0,0 +1,70 @@
+/*
+ * File: chime.h
+ * Purpose: Table-driven chime sequencer for the PWM buzzer (MISRA C:2012 aligned)
+ *
+ * A chime is a const, flash-resident list of steps (tone, duty, duration)
+ * played a given number of times. A player is a small cursor into one
+ * chime; players are owned by the audio arbiter (one per client), so adding
+ * a chime is a data-only change and RAM use does not grow.
+ * The current step is computed from the time since start, so a player
+ * re-evaluated late (stall, dropped ticks) lands on the step that is due
+ * rather than replaying the ones it missed. EVT_BUZZER_TICK only sets how
+ * often that happens: a step boundary is seen at most CHIME_TICK_MS late.
+ * A beat-locked chime (turn/hazard tick) instead restarts on every flasher
+ * beat and holds its last step until the next one, so it follows the lamp
+ * edges whatever the lamp tempo; loops does not apply to it.
+ */
+
+#ifndef CHIME_H
+#define CHIME_H
+
+#include <stdint.h>
+
+/* Re-evaluation period: one EVT_BUZZER_TICK */
+#define CHIME_TICK_MS                     (20U)
+
+/* Tolerance for tick jitter when a boundary is due right at a tick */
+#define CHIME_SLACK_US                    (100U)
+
+/* Loop count meaning "repeat until stopped" */
+#define CHIME_LOOP_FOREVER                (0U)
+
+typedef struct
+{
+    uint16_t tone_hz;        /* 0 => silence */
+    uint16_t duty_permille;  /* share of the tone period the output is high */
+    uint16_t duration_ms;    /* multiple of CHIME_TICK_MS */
+} chime_step_t;
+
+typedef struct
+{
+    const chime_step_t *steps;
+    uint8_t             count;
+    uint8_t             loops;   /* CHIME_LOOP_FOREVER or number of plays */
+    uint8_t             beat_locked;  /* 1 => phase from the flasher beat */
+} chime_t;
+
+/* Built-in chimes */
+extern const chime_t Chime_Turn;      /* 40 ms on per flasher beat */
+extern const chime_t Chime_Hazard;    /* 20 ms on per flasher beat */
+extern const chime_t Chime_Seatbelt;  /* 200 ms on, 800 ms off */
+
+/* Playback cursor */
+typedef struct
+{
+    const chime_t *chime;       /* NULL => finished or idle */
+    uint64_t       start_us;    /* time_now_us() at start */
+    uint8_t        step;
+} chime_player_t;
+
+/* Public API */
+/* Start c from its first step at now_us */
+void                Chime_Player_Start(chime_player_t *p, const chime_t *c, uint64_t now_us);
+/* Move p to the step due at now_us; returns 1 while it is still playing */
+uint8_t             Chime_Player_Update(chime_player_t *p, uint64_t now_us);
+/* Current step, NULL once finished */
+const chime_step_t *Chime_Player_Step(const chime_player_t *p);
+/* Drive the buzzer for a step; NULL or a silent step turns it off */
+void                Chime_Output(const chime_step_t *s);
+
+#endif /* CHIME_H */
@@ -0,0 +1,166 @@
+/*
+ * File: clock_plan.h
+ * Purpose: Compile-time clock tree plan for LPC17xx (MISRA C:2012 aligned)
+ *
+ * Inputs are the crystal, the target CCLK and the wanted peripheral rates;
+ * every PLL0, CCLK, PCLK, TIMER0, PWM1 and SSP0 divider is derived here.
+ * Combinations the hardware cannot produce stop the build with #error, so
+ * retuning CCLK cannot silently skew timing in the drivers.
+ *
+ * All macros are plain integer constant expressions (no casts) so they can
+ * be used both in C code and in #if arithmetic.
+ */
+
+#ifndef CLOCK_PLAN_H
+#define CLOCK_PLAN_H
+
+/*
+ * Plan inputs (override on the compiler command line if needed)
+ */
+#ifndef CLOCK_PLAN_XTAL_HZ
+#define CLOCK_PLAN_XTAL_HZ                (12000000UL)   /* Main oscillator */
+#endif
+
+#ifndef CLOCK_PLAN_CCLK_HZ
+#define CLOCK_PLAN_CCLK_HZ                (100000000UL)  /* Target CPU clock */
+#endif
+
+#ifndef CLOCK_PLAN_PLL0_N
+#define CLOCK_PLAN_PLL0_N                 (2UL)          /* PLL0 pre-divider */
+#endif
+
+#ifndef CLOCK_PLAN_PCLK_DIV
+#define CLOCK_PLAN_PCLK_DIV               (4UL)          /* CCLK/PCLK: 1, 2, 4 or 8 */
+#endif
+
+#ifndef CLOCK_PLAN_TIMER0_TICK_HZ
+#define CLOCK_PLAN_TIMER0_TICK_HZ         (1000000UL)    /* TIMER0 count rate (1 us) */
+#endif
+
+#ifndef CLOCK_PLAN_PWM1_PRESCALE
+#define CLOCK_PLAN_PWM1_PRESCALE          (10UL)         /* PWM1 PR register */
+#endif
+
+#ifndef CLOCK_PLAN_SSP0_SCK_HZ
+#define CLOCK_PLAN_SSP0_SCK_HZ            (1250000UL)    /* 74HC595 shift clock */
+#endif
+
+#ifndef CLOCK_PLAN_SSP0_SCK_TOL_PCT
+#define CLOCK_PLAN_SSP0_SCK_TOL_PCT       (5UL)          /* Allowed SCK deviation */
+#endif
+
+/*
+ * Device limits (UM10360 chapter 4)
+ */
+#define CLOCK_PLAN_FCCO_MIN_HZ            (275000000UL)
+#define CLOCK_PLAN_FCCO_MAX_HZ            (550000000UL)
+#define CLOCK_PLAN_CCLK_MAX_HZ            (100000000UL)
+#define CLOCK_PLAN_PLL0_FIN_MIN_HZ        (32000UL)
+#define CLOCK_PLAN_PLL0_FIN_MAX_HZ        (50000000UL)
+
+/*
+ * PLL0 / CCLK: smallest CCLK divider that lifts FCCO into its range,
+ * then M = FCCO * N / (2 * Fin)
+ */
+#define CLOCK_PLAN_CCLK_DIV               ((CLOCK_PLAN_FCCO_MIN_HZ + CLOCK_PLAN_CCLK_HZ - 1UL) / CLOCK_PLAN_CCLK_HZ)
+#define CLOCK_PLAN_FCCO_HZ                (CLOCK_PLAN_CCLK_HZ * CLOCK_PLAN_CCLK_DIV)
+#define CLOCK_PLAN_PLL0_M                 ((CLOCK_PLAN_FCCO_HZ * CLOCK_PLAN_PLL0_N) / (2UL * CLOCK_PLAN_XTAL_HZ))
+
+/* Oscillator range select: 0 => 1-20 MHz, 1 => 15-25 MHz */
+#if (CLOCK_PLAN_XTAL_HZ > 20000000UL)
+#define CLOCK_PLAN_OSCRANGE_HIGH          (1UL)
+#else
+#define CLOCK_PLAN_OSCRANGE_HIGH          (0UL)
+#endif
+
+/*
+ * Peripheral clock (one PCLK shared by TIMER0, PWM1 and SSP0)
+ */
+#define CLOCK_PLAN_PCLK_HZ                (CLOCK_PLAN_CCLK_HZ / CLOCK_PLAN_PCLK_DIV)
+
+/* 2-bit PCLKSEL field value: 00 => /4, 01 => /1, 10 => /2, 11 => /8 */
+#if (CLOCK_PLAN_PCLK_DIV == 1UL)
+#define CLOCK_PLAN_PCLKSEL_BITS           (1UL)
+#elif (CLOCK_PLAN_PCLK_DIV == 2UL)
+#define CLOCK_PLAN_PCLKSEL_BITS           (2UL)
+#elif (CLOCK_PLAN_PCLK_DIV == 4UL)
+#define CLOCK_PLAN_PCLKSEL_BITS           (0UL)
+#elif (CLOCK_PLAN_PCLK_DIV == 8UL)
+#define CLOCK_PLAN_PCLKSEL_BITS           (3UL)
+#else
+#error "clock_plan: CLOCK_PLAN_PCLK_DIV must be 1, 2, 4 or 8"
+#endif
+
+/*
+ * TIMER0: prescaler for the requested count rate
+ */
+#define CLOCK_PLAN_TIMER0_PR              ((CLOCK_PLAN_PCLK_HZ / CLOCK_PLAN_TIMER0_TICK_HZ) - 1UL)
+#define CLOCK_PLAN_TIMER0_TICKS_PER_MS    (CLOCK_PLAN_TIMER0_TICK_HZ / 1000UL)
+
+/*
+ * PWM1: tick rate from the chosen prescaler; period ticks for a frequency
+ * (rounded to nearest)
+ */
+#define CLOCK_PLAN_PWM1_DIV               (CLOCK_PLAN_PWM1_PRESCALE + 1UL)
+#define CLOCK_PLAN_PWM1_TICKS(hz)         ((CLOCK_PLAN_PCLK_HZ + ((CLOCK_PLAN_PWM1_DIV * (hz)) / 2UL)) / (CLOCK_PLAN_PWM1_DIV * (hz)))
+
+/*
+ * SSP0: SCK = PCLK / (CPSR * (SCR + 1)), CPSR even in 2..254, SCR 0..255.
+ * Smallest even CPSR that keeps SCR in range, then SCR rounded to nearest.
+ */
+#define CLOCK_PLAN_SSP0_CPSR_RAW          ((CLOCK_PLAN_PCLK_HZ + (CLOCK_PLAN_SSP0_SCK_HZ * 256UL) - 1UL) / (CLOCK_PLAN_SSP0_SCK_HZ * 256UL))
+#if (CLOCK_PLAN_SSP0_CPSR_RAW < 2UL)
+#define CLOCK_PLAN_SSP0_CPSR              (2UL)
+#else
+#define CLOCK_PLAN_SSP0_CPSR              (((CLOCK_PLAN_SSP0_CPSR_RAW + 1UL) / 2UL) * 2UL)
+#endif
+#define CLOCK_PLAN_SSP0_SCR_DIV           ((CLOCK_PLAN_PCLK_HZ + ((CLOCK_PLAN_SSP0_CPSR * CLOCK_PLAN_SSP0_SCK_HZ) / 2UL)) / (CLOCK_PLAN_SSP0_CPSR * CLOCK_PLAN_SSP0_SCK_HZ))
+#define CLOCK_PLAN_SSP0_SCR               (CLOCK_PLAN_SSP0_SCR_DIV - 1UL)
+#define CLOCK_PLAN_SSP0_ACTUAL_HZ         (CLOCK_PLAN_PCLK_HZ / (CLOCK_PLAN_SSP0_CPSR * CLOCK_PLAN_SSP0_SCR_DIV))
+
+/*
+ * Build-time validation
+ */
+#if (CLOCK_PLAN_CCLK_HZ > CLOCK_PLAN_CCLK_MAX_HZ)
+#error "clock_plan: CCLK exceeds 100 MHz"
+#endif
+#if ((CLOCK_PLAN_PLL0_N < 1UL) || (CLOCK_PLAN_PLL0_N > 32UL))
+#error "clock_plan: PLL0 N out of range 1..32"
+#endif
+#if (((CLOCK_PLAN_XTAL_HZ / CLOCK_PLAN_PLL0_N) < CLOCK_PLAN_PLL0_FIN_MIN_HZ) || \
+     ((CLOCK_PLAN_XTAL_HZ / CLOCK_PLAN_PLL0_N) > CLOCK_PLAN_PLL0_FIN_MAX_HZ))
+#error "clock_plan: PLL0 input (XTAL / N) out of range"
+#endif
+#if (CLOCK_PLAN_FCCO_HZ > CLOCK_PLAN_FCCO_MAX_HZ)
+#error "clock_plan: no CCLK divider keeps FCCO within 275..550 MHz"
+#endif
+#if (CLOCK_PLAN_CCLK_DIV > 256UL)
+#error "clock_plan: CCLK divider exceeds 256"
+#endif
+#if ((CLOCK_PLAN_FCCO_HZ * CLOCK_PLAN_PLL0_N) > 0xFFFFFFFFUL)
+#error "clock_plan: FCCO * N overflows 32-bit arithmetic, lower PLL0 N"
+#endif
+#if (((CLOCK_PLAN_FCCO_HZ * CLOCK_PLAN_PLL0_N) % (2UL * CLOCK_PLAN_XTAL_HZ)) != 0UL)
+#error "clock_plan: target CCLK not reachable exactly from this crystal and PLL0 N"
+#endif
+#if ((CLOCK_PLAN_PLL0_M < 6UL) || (CLOCK_PLAN_PLL0_M > 512UL))
+#error "clock_plan: PLL0 M out of range 6..512"
+#endif
+#if ((CLOCK_PLAN_CCLK_HZ % CLOCK_PLAN_PCLK_DIV) != 0UL)
+#error "clock_plan: PCLK is not an integer frequency"
+#endif
+#if ((CLOCK_PLAN_TIMER0_TICK_HZ < 1000UL) || ((CLOCK_PLAN_PCLK_HZ % CLOCK_PLAN_TIMER0_TICK_HZ) != 0UL))
+#error "clock_plan: TIMER0 tick must be >= 1 kHz and divide PCLK exactly"
+#endif
+#if (CLOCK_PLAN_SSP0_SCK_HZ > (CLOCK_PLAN_PCLK_HZ / 2UL))
+#error "clock_plan: SSP0 SCK above PCLK/2 (master limit)"
+#endif
+#if ((CLOCK_PLAN_SSP0_CPSR > 254UL) || (CLOCK_PLAN_SSP0_SCR > 255UL))
+#error "clock_plan: SSP0 SCK too slow for CPSR/SCR"
+#endif
+#if (((CLOCK_PLAN_SSP0_ACTUAL_HZ * 100UL) > (CLOCK_PLAN_SSP0_SCK_HZ * (100UL + CLOCK_PLAN_SSP0_SCK_TOL_PCT))) || \
+     ((CLOCK_PLAN_SSP0_ACTUAL_HZ * 100UL) < (CLOCK_PLAN_SSP0_SCK_HZ * (100UL - CLOCK_PLAN_SSP0_SCK_TOL_PCT))))
+#error "clock_plan: SSP0 SCK not reachable within tolerance from this PCLK"
+#endif
+
+#endif /* CLOCK_PLAN_H */
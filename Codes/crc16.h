@@ -0,0 +1,19 @@
+/*
+ * File: crc16.h
+ * Purpose: CRC-16/CCITT for stored records (MISRA C:2012 aligned)
+ *
+ * Same polynomial and start value as Plans/Indicators logic/codex_pseudocode.c
+ * (0x1021, 0xFFFF), so records written by either check the same.
+ */
+
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <stdint.h>
+
+#define CRC16_INIT                        (0xFFFFU)
+
+/* Continue crc over len bytes; start with CRC16_INIT */
+uint16_t Crc16_Ccitt(const uint8_t *data, uint32_t len, uint16_t crc);
+
+#endif /* CRC16_H */
@@ -0,0 +1,27 @@
+/*
+ * File: critical.h
+ * Purpose: Nestable interrupt-masking critical sections (MISRA C:2012 aligned)
+ *
+ * Critical_Enter() returns the previous PRIMASK so sections can nest and can
+ * be used from both main and ISR context.
+ */
+
+#ifndef CRITICAL_H
+#define CRITICAL_H
+
+#include <stdint.h>
+#include "LPC17xx.h"
+
+static __INLINE uint32_t Critical_Enter(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+static __INLINE void Critical_Exit(uint32_t primask)
+{
+    __set_PRIMASK(primask);
+}
+
+#endif /* CRITICAL_H */
@@ -0,0 +1,33 @@
+/*
+ * File: cycles.h
+ * Purpose: Core clock cycle counter for cost measurements (MISRA C:2012 aligned)
+ *
+ * Uses the DWT cycle counter, which the CMSIS v1 core header does not
+ * describe. The count wraps every 2^32 cycles (~43 s at 100 MHz), so
+ * differences of uint32_t readings are valid for any shorter interval.
+ */
+
+#ifndef CYCLES_H
+#define CYCLES_H
+
+#include <stdint.h>
+#include "LPC17xx.h"
+
+#define CYCLES_DWT_CTRL                   (*(volatile uint32_t *)0xE0001000UL)
+#define CYCLES_DWT_CYCCNT                 (*(volatile uint32_t *)0xE0001004UL)
+#define CYCLES_DWT_CTRL_CYCCNTENA_MASK    (1UL << 0)
+
+/* Start the counter; trace must be enabled for the DWT to run */
+static __INLINE void Cycles_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA;
+    CYCLES_DWT_CYCCNT = 0U;
+    CYCLES_DWT_CTRL  |= CYCLES_DWT_CTRL_CYCCNTENA_MASK;
+}
+
+static __INLINE uint32_t Cycles_Now(void)
+{
+    return CYCLES_DWT_CYCCNT;
+}
+
+#endif /* CYCLES_H */
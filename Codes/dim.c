@@ -0,0 +1,128 @@
+/*
+ * File: dim.c
+ * Purpose: Gamma-corrected lamp brightness ramps over the PWM1.2 /OE duty.
+ * Notes: The ramp position is computed from elapsed time, like the
+ *        animations, so a late update lands on the right level. PWM1.2
+ *        registers are written only when the level actually changes.
+ */
+
+#include <stdint.h>
+#include "pwm.h"
+#include "dim.h"
+
+/* Q16 lit share of the PWM period per perceptual level: 65535 * (i/255)^2.2 */
+static const uint16_t dim_gamma[DIM_LEVEL_MAX + 1U] =
+{
+        0U,     0U,     2U,     4U,     7U,    11U,    17U,    24U,
+       32U,    42U,    53U,    65U,    79U,    94U,   111U,   129U,
+      148U,   169U,   192U,   216U,   242U,   270U,   299U,   330U,
+      362U,   396U,   432U,   469U,   508U,   549U,   591U,   635U,
+      681U,   729U,   779U,   830U,   883U,   938U,   995U,  1053U,
+     1113U,  1175U,  1239U,  1305U,  1373U,  1443U,  1514U,  1587U,
+     1663U,  1740U,  1819U,  1900U,  1983U,  2068U,  2155U,  2243U,
+     2334U,  2427U,  2521U,  2618U,  2717U,  2817U,  2920U,  3024U,
+     3131U,  3240U,  3350U,  3463U,  3578U,  3694U,  3813U,  3934U,
+     4057U,  4182U,  4309U,  4438U,  4570U,  4703U,  4838U,  4976U,
+     5115U,  5257U,  5401U,  5547U,  5695U,  5845U,  5998U,  6152U,
+     6309U,  6468U,  6629U,  6792U,  6957U,  7124U,  7294U,  7466U,
+     7640U,  7816U,  7994U,  8175U,  8358U,  8543U,  8730U,  8919U,
+     9111U,  9305U,  9501U,  9699U,  9900U, 10102U, 10307U, 10515U,
+    10724U, 10936U, 11150U, 11366U, 11585U, 11806U, 12029U, 12254U,
+    12482U, 12712U, 12944U, 13179U, 13416U, 13655U, 13896U, 14140U,
+    14386U, 14635U, 14885U, 15138U, 15394U, 15652U, 15912U, 16174U,
+    16439U, 16706U, 16975U, 17247U, 17521U, 17798U, 18077U, 18358U,
+    18642U, 18928U, 19216U, 19507U, 19800U, 20095U, 20393U, 20694U,
+    20996U, 21301U, 21609U, 21919U, 22231U, 22546U, 22863U, 23182U,
+    23504U, 23829U, 24156U, 24485U, 24817U, 25151U, 25487U, 25826U,
+    26168U, 26512U, 26858U, 27207U, 27558U, 27912U, 28268U, 28627U,
+    28988U, 29351U, 29717U, 30086U, 30457U, 30830U, 31206U, 31585U,
+    31966U, 32349U, 32735U, 33124U, 33514U, 33908U, 34304U, 34702U,
+    35103U, 35507U, 35913U, 36321U, 36732U, 37146U, 37562U, 37981U,
+    38402U, 38825U, 39252U, 39680U, 40112U, 40546U, 40982U, 41421U,
+    41862U, 42306U, 42753U, 43202U, 43654U, 44108U, 44565U, 45025U,
+    45487U, 45951U, 46418U, 46888U, 47360U, 47835U, 48313U, 48793U,
+    49275U, 49761U, 50249U, 50739U, 51232U, 51728U, 52226U, 52727U,
+    53230U, 53736U, 54245U, 54756U, 55270U, 55787U, 56306U, 56828U,
+    57352U, 57879U, 58409U, 58941U, 59476U, 60014U, 60554U, 61097U,
+    61642U, 62190U, 62741U, 63295U, 63851U, 64410U, 64971U, 65535U
+};
+
+static uint8_t  dim_level;       /* level currently driven */
+static uint8_t  dim_from;
+static uint8_t  dim_to;
+static uint64_t dim_start_us;
+static uint32_t dim_ramp_us;     /* 0 => no ramp running */
+static uint8_t  dim_night;
+
+static void dim_apply(uint8_t level)
+{
+    if (level != dim_level)
+    {
+        dim_level = level;
+        PWM_Lamp_Set_Duty(dim_gamma[level]);
+    }
+}
+
+void Dim_Init(void)
+{
+    dim_ramp_us = 0U;
+    dim_night   = 0U;
+    dim_to      = DIM_LEVEL_DAY;
+    dim_level   = DIM_LEVEL_DAY;
+    PWM_Lamp_Set_Duty(dim_gamma[DIM_LEVEL_DAY]);
+}
+
+void Dim_Set_Level(uint8_t level, uint16_t ramp_ms, uint64_t now_us)
+{
+    dim_to = level;
+    if (ramp_ms == 0U)
+    {
+        dim_ramp_us = 0U;
+        dim_apply(level);
+        return;
+    }
+
+    /* Start from wherever a running ramp has got to */
+    dim_from     = dim_level;
+    dim_start_us = now_us;
+    dim_ramp_us  = (uint32_t)ramp_ms * 1000U;
+}
+
+void Dim_Set_Night(uint8_t night, uint64_t now_us)
+{
+    uint8_t want = (night != 0U) ? 1U : 0U;
+
+    if (want != dim_night)
+    {
+        dim_night = want;
+        Dim_Set_Level((want != 0U) ? (uint8_t)DIM_LEVEL_NIGHT : (uint8_t)DIM_LEVEL_DAY,
+                      (uint16_t)DIM_RAMP_MS, now_us);
+    }
+}
+
+void Dim_Update(uint64_t now_us)
+{
+    uint64_t t;
+    int32_t  span;
+
+    if (dim_ramp_us == 0U)
+    {
+        return;
+    }
+
+    t = (now_us > dim_start_us) ? (now_us - dim_start_us) : 0U;
+    if (t >= dim_ramp_us)
+    {
+        dim_ramp_us = 0U;
+        dim_apply(dim_to);
+        return;
+    }
+
+    span = (int32_t)dim_to - (int32_t)dim_from;
+    dim_apply((uint8_t)((int32_t)dim_from + (int32_t)(((int64_t)span * (int64_t)t) / (int64_t)dim_ramp_us)));
+}
+
+uint8_t Dim_Level(void)
+{
+    return dim_level;
+}
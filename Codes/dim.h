@@ -0,0 +1,36 @@
+/*
+ * File: dim.h
+ * Purpose: Global lamp brightness with gamma correction and ramps (MISRA C:2012 aligned)
+ *
+ * Brightness is a perceptual level 0..DIM_LEVEL_MAX. A const gamma table
+ * turns it into the /OE duty of PWM1.2, so equal level steps look equally
+ * large. Level changes ramp linearly over time and are re-evaluated from a
+ * periodic task; the PWM hardware does the rest, so a steady brightness
+ * costs no CPU and no SSP0 traffic.
+ */
+
+#ifndef DIM_H
+#define DIM_H
+
+#include <stdint.h>
+
+#define DIM_LEVEL_MAX                     (255U)
+#define DIM_LEVEL_DAY                     (255U)
+#define DIM_LEVEL_NIGHT                   (72U)    /* ~6 % luminance */
+
+/* Day/night transition time and re-evaluation period while ramping */
+#define DIM_RAMP_MS                       (1500U)
+#define DIM_UPDATE_MS                     (20U)
+
+/* Public API (main context) */
+/* Day brightness at once */
+void    Dim_Init(void);
+/* Ramp from the current level to level over ramp_ms (0 => at once) */
+void    Dim_Set_Level(uint8_t level, uint16_t ramp_ms, uint64_t now_us);
+/* Ramp to the night or day level; no effect if already heading there */
+void    Dim_Set_Night(uint8_t night, uint64_t now_us);
+/* Advance a running ramp; call every DIM_UPDATE_MS */
+void    Dim_Update(uint64_t now_us);
+uint8_t Dim_Level(void);
+
+#endif /* DIM_H */
@@ -0,0 +1,65 @@
+/*
+ * File: dma.c
+ * Purpose: GPDMA controller bring-up and per-channel interrupt dispatch.
+ * Notes: Each client owns a fixed channel (see dma.h) and programs its
+ *        channel registers directly; this module only powers the block and
+ *        routes terminal-count / error interrupts.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "dma.h"
+
+static dma_done_cb_t dma_callbacks[DMA_NUM_CHANNELS];
+
+void DMA_Init(void)
+{
+    if ((LPC_SC->PCONP & PCONP_PCGPDMA_MASK) != 0UL)
+    {
+        return; /* already brought up by another client */
+    }
+
+    /* 1) Power GPDMA */
+    LPC_SC->PCONP |= PCONP_PCGPDMA_MASK;
+
+    /* 2) Clear any stale channel interrupts, then enable (little-endian) */
+    LPC_GPDMA->IntTCClear = 0xFFUL;
+    LPC_GPDMA->IntErrClr  = 0xFFUL;
+    LPC_GPDMA->Config     = DMA_CONFIG_E_MASK;
+    while ((LPC_GPDMA->Config & DMA_CONFIG_E_MASK) == 0UL) {
+        /* wait for controller enable */
+    }
+
+    NVIC_EnableIRQ(DMA_IRQn);
+}
+
+void DMA_Set_Callback(uint8_t channel, dma_done_cb_t done_cb)
+{
+    if (channel < DMA_NUM_CHANNELS)
+    {
+        dma_callbacks[channel] = done_cb;
+    }
+}
+
+void DMA_IRQHandler(void)
+{
+    uint32_t tc  = LPC_GPDMA->IntTCStat;
+    uint32_t err = LPC_GPDMA->IntErrStat;
+    uint8_t  ch;
+
+    LPC_GPDMA->IntTCClear = tc;
+    LPC_GPDMA->IntErrClr  = err;
+
+    for (ch = 0U; ch < DMA_NUM_CHANNELS; ch++)
+    {
+        uint32_t mask = (1UL << ch);
+        if (((tc | err) & mask) != 0UL)
+        {
+            if (dma_callbacks[ch] != NULL)
+            {
+                dma_callbacks[ch](ch, ((err & mask) != 0UL) ? DMA_STATUS_ERROR : DMA_STATUS_OK);
+            }
+        }
+    }
+}
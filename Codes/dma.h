@@ -0,0 +1,102 @@
+/*
+ * File: dma.h
+ * Purpose: GPDMA channel ownership and interrupt dispatch (MISRA C:2012 aligned)
+ */
+
+#ifndef DMA_H
+#define DMA_H
+
+#include <stdint.h>
+#include "LPC17xx.h"
+
+/*
+ * Peripheral power
+ */
+#define PCONP_PCGPDMA_MASK                (1UL << 29)  /* Power to GPDMA */
+
+/*
+ * Fixed channel assignment (channel 0 has the highest priority).
+ * The RX side of a full-duplex transfer sits above its TX side so the
+ * receive FIFO is always drained before it can overrun.
+ */
+#define DMA_CH_HC595_RX                   (0U)
+#define DMA_CH_HC595_TX                   (1U)
+#define DMA_CH_PCM                        (2U)
+#define DMA_CH_ADC                        (3U)
+#define DMA_NUM_CHANNELS                  (8U)
+
+/* Distance between two channel register blocks */
+#define DMA_CH_STRIDE                     (0x20UL)
+
+/*
+ * Hardware request lines (SrcPeripheral / DestPeripheral)
+ */
+#define DMA_PERIPH_SSP0_TX                (0UL)
+#define DMA_PERIPH_SSP0_RX                (1UL)
+#define DMA_PERIPH_ADC                    (4UL)
+#define DMA_PERIPH_DAC                    (7UL)
+
+/*
+ * DMACConfig register fields
+ */
+#define DMA_CONFIG_E_MASK                 (1UL << 0)   /* Controller enable */
+
+/*
+ * DMACCxControl register fields
+ */
+#define DMA_CTRL_SIZE_MASK                (0xFFFUL)    /* Transfer size [11:0] */
+#define DMA_CTRL_SBSIZE_1                 (0UL << 12)
+#define DMA_CTRL_DBSIZE_1                 (0UL << 15)
+#define DMA_CTRL_SWIDTH_8BIT              (0UL << 18)
+#define DMA_CTRL_DWIDTH_8BIT              (0UL << 21)
+#define DMA_CTRL_SWIDTH_32BIT             (2UL << 18)
+#define DMA_CTRL_DWIDTH_32BIT             (2UL << 21)
+#define DMA_CTRL_SI_MASK                  (1UL << 26)  /* Source increment */
+#define DMA_CTRL_DI_MASK                  (1UL << 27)  /* Destination increment */
+#define DMA_CTRL_I_MASK                   (1UL << 31)  /* Terminal count interrupt */
+
+/*
+ * DMACCxConfig register fields
+ */
+#define DMA_CCFG_E_MASK                   (1UL << 0)   /* Channel enable */
+#define DMA_CCFG_SRCPERIPH(p)             ((uint32_t)(p) << 1)
+#define DMA_CCFG_DESTPERIPH(p)            ((uint32_t)(p) << 6)
+#define DMA_CCFG_TT_M2P                   (1UL << 11)  /* Memory to peripheral */
+#define DMA_CCFG_TT_P2M                   (2UL << 11)  /* Peripheral to memory */
+#define DMA_CCFG_IE_MASK                  (1UL << 14)  /* Error interrupt mask */
+#define DMA_CCFG_ITC_MASK                 (1UL << 15)  /* Terminal count interrupt mask */
+
+/* Maximum transfer length of a single (non-linked) descriptor */
+#define DMA_MAX_TRANSFER                  (4095UL)
+
+/* Linked list item, as fetched by the controller (word aligned) */
+typedef struct
+{
+    uint32_t src;
+    uint32_t dst;
+    uint32_t next;      /* address of the next item, 0 => last */
+    uint32_t control;   /* DMACCxControl for this item */
+} dma_lli_t;
+
+/* Status codes for DMA completion */
+typedef enum
+{
+    DMA_STATUS_OK = 0,
+    DMA_STATUS_ERROR = 1
+} dma_status_t;
+
+/* Completion callback, invoked from DMA ISR context */
+typedef void (*dma_done_cb_t)(uint8_t channel, dma_status_t status);
+
+/* Register block of one channel */
+#define DMA_CHANNEL(ch)   ((LPC_GPDMACH_TypeDef *)(LPC_GPDMACH0_BASE + ((uint32_t)(ch) * DMA_CH_STRIDE)))
+
+/* Public API */
+/* Power and enable the controller; safe to call from every client init */
+void DMA_Init(void);
+/* Route terminal-count / error interrupts of a channel to done_cb */
+void DMA_Set_Callback(uint8_t channel, dma_done_cb_t done_cb);
+
+void DMA_IRQHandler(void);
+
+#endif /* DMA_H */
@@ -0,0 +1,91 @@
+/*
+ * File: evq.c
+ * Purpose: SPSC event ring with free-running head/tail indices.
+ * Notes: Indices wrap at 2^32 and are masked on access, so full and empty
+ *        are told apart without a spare slot. The barriers order the slot
+ *        copy against the index store that publishes or releases it.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "evq.h"
+#include "systime.h"
+
+#define EVQ_MASK                          (EVQ_SIZE - 1U)
+
+void EvQ_Init(evq_t *q)
+{
+    if (q != NULL)
+    {
+        q->head    = 0U;
+        q->tail    = 0U;
+        q->dropped = 0U;
+    }
+}
+
+evq_status_t EvQ_Post(evq_t *q, uint8_t id, uint8_t arg)
+{
+    return EvQ_Post_At(q, id, arg, time_now_us());
+}
+
+evq_status_t EvQ_Post_At(evq_t *q, uint8_t id, uint8_t arg, uint64_t time_us)
+{
+    uint32_t head;
+    evt_t   *e;
+
+    if (q == NULL)
+    {
+        return EVQ_STATUS_INVALID_PARAM;
+    }
+
+    head = q->head;
+    if ((head - q->tail) >= EVQ_SIZE)
+    {
+        q->dropped++;
+        return EVQ_STATUS_FULL;
+    }
+
+    e = &q->buf[head & EVQ_MASK];
+    e->time_us = time_us;
+    e->id      = id;
+    e->arg     = arg;
+
+    __DMB(); /* slot contents before the index that publishes it */
+    q->head = head + 1U;
+    return EVQ_STATUS_OK;
+}
+
+uint32_t EvQ_Drain(evq_t *q, evt_t *out, uint32_t max)
+{
+    uint32_t tail;
+    uint32_t avail;
+    uint32_t n;
+
+    if ((q == NULL) || (out == NULL))
+    {
+        return 0U;
+    }
+
+    tail  = q->tail;
+    avail = q->head - tail;
+    __DMB(); /* index before the slot contents it covers */
+
+    if (avail > max)
+    {
+        avail = max;
+    }
+    for (n = 0U; n < avail; n++)
+    {
+        out[n] = q->buf[(tail + n) & EVQ_MASK];
+    }
+
+    __DMB(); /* finish reading before the producer may reuse the slots */
+    q->tail = tail + avail;
+    return avail;
+}
+
+uint32_t EvQ_Count(const evq_t *q)
+{
+    return (q != NULL) ? (q->head - q->tail) : 0U;
+}
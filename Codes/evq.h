@@ -0,0 +1,69 @@
+/*
+ * File: evq.h
+ * Purpose: Lock-free single-producer/single-consumer event ring (MISRA C:2012 aligned)
+ *
+ * One ring per producing context (e.g. the TIMER0 ISR): the producer only
+ * writes head, the consumer only writes tail, so posting from an ISR and
+ * draining from the main loop need no interrupt masking. Every event
+ * carries the time_now_us() value of the moment it was posted. A full ring
+ * rejects the event and counts it in dropped, so loss is never silent.
+ */
+
+#ifndef EVQ_H
+#define EVQ_H
+
+#include <stdint.h>
+
+/* Ring capacity, must be a power of two */
+#define EVQ_SIZE                          (32U)
+
+#if ((EVQ_SIZE & (EVQ_SIZE - 1U)) != 0U)
+#error "evq: EVQ_SIZE must be a power of two"
+#endif
+
+/* Status codes for event queue APIs */
+typedef enum
+{
+    EVQ_STATUS_OK = 0,
+    EVQ_STATUS_INVALID_PARAM = 1,
+    EVQ_STATUS_FULL = 2
+} evq_status_t;
+
+/* Event identifiers */
+typedef enum
+{
+    EVT_NONE = 0,
+    EVT_LED1_TICK = 1,      /* indicator pace, LED1 period */
+    EVT_LED2_TICK = 2,      /* indicator pace, LED2 period */
+    EVT_BUZZER_TICK = 3,    /* buzzer cadence, 20 ms */
+    EVT_FLASH_BEAT = 4,     /* shared lamp/tick-sound beat, see flasher.h */
+    EVT_INPUT = 5           /* debounced switch change, see input.h */
+} evt_id_t;
+
+typedef struct
+{
+    uint64_t time_us;       /* time_now_us() when posted (or supplied) */
+    uint8_t  id;            /* evt_id_t */
+    uint8_t  arg;
+} evt_t;
+
+typedef struct
+{
+    evt_t             buf[EVQ_SIZE];
+    volatile uint32_t head;     /* free-running, written by the producer */
+    volatile uint32_t tail;     /* free-running, written by the consumer */
+    volatile uint32_t dropped;  /* events rejected because the ring was full */
+} evq_t;
+
+/* Public API */
+void         EvQ_Init(evq_t *q);
+/* Producer side: stamp with the current time and publish */
+evq_status_t EvQ_Post(evq_t *q, uint8_t id, uint8_t arg);
+/* Producer side with a caller-supplied stamp, e.g. when the event happened
+   earlier than it is posted */
+evq_status_t EvQ_Post_At(evq_t *q, uint8_t id, uint8_t arg, uint64_t time_us);
+/* Consumer side: copy up to max events into out, oldest first; returns count */
+uint32_t     EvQ_Drain(evq_t *q, evt_t *out, uint32_t max);
+uint32_t     EvQ_Count(const evq_t *q);
+
+#endif /* EVQ_H */
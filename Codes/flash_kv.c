@@ -0,0 +1,414 @@
+/*
+ * File: flash_kv.c
+ * Purpose: Flash key/value log: RAM index, page-batched appends, compaction.
+ * Notes: Each page is programmed once, from a word-aligned RAM buffer, and
+ *        read back from the memory map to verify it. Flushes start on a
+ *        fresh page, so the end of the log is the first page whose first
+ *        slot is still erased. A record's first word is the key and a
+ *        CRC-16 of key and value; unused (erased) slots and records torn by
+ *        a power loss fail that check on replay and are skipped.
+ *        Page 0 holds only the sector header: magic, generation and its
+ *        complement. A compaction programs it after every record, so a
+ *        sector whose header checks out is complete.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "critical.h"
+#include "cycles.h"
+#include "clock_plan.h"
+#include "crc16.h"
+#include "flash_kv.h"
+
+typedef void (*flash_kv_iap_t)(uint32_t *cmd, uint32_t *res);
+
+#define FLASH_KV_ERASED        (0xFFFFFFFFUL)
+#define FLASH_KV_PAGE_WORDS    (FLASH_KV_PAGE_BYTES / 4U)
+#define FLASH_KV_CCLK_KHZ      (CLOCK_PLAN_CCLK_HZ / 1000UL)
+#define FLASH_KV_CYCLES_PER_US (CLOCK_PLAN_CCLK_HZ / 1000000UL)
+
+static const uint32_t flash_kv_base[2]   = { FLASH_KV_SECTOR_A_BASE, FLASH_KV_SECTOR_B_BASE };
+static const uint32_t flash_kv_sector[2] = { FLASH_KV_SECTOR_A, FLASH_KV_SECTOR_B };
+
+/* RAM index: the current value of every key */
+static uint32_t         flash_kv_value[FLASH_KV_KEYS];
+static uint32_t         flash_kv_present;     /* key bit set: has a value */
+static uint32_t         flash_kv_dirty;       /* key bit set: not in flash yet */
+
+static uint8_t          flash_kv_active;      /* 0 => A, 1 => B */
+static uint8_t          flash_kv_active_valid;
+static uint8_t          flash_kv_spare_blank;
+static uint32_t         flash_kv_gen;
+static uint32_t         flash_kv_next_page;   /* first unwritten page of the active sector */
+static flash_kv_stats_t flash_kv_stats;
+
+/* Page being assembled; IAP copies from word-aligned RAM */
+static uint32_t         flash_kv_page[FLASH_KV_PAGE_WORDS];
+static uint32_t         flash_kv_fill;        /* records in flash_kv_page */
+
+static uint32_t flash_kv_word(uint32_t addr)
+{
+    return *(const volatile uint32_t *)addr;
+}
+
+static uint8_t flash_kv_blank(uint8_t s)
+{
+    uint32_t i;
+
+    for (i = 0U; i < FLASH_KV_SECTOR_BYTES; i += 4U)
+    {
+        if (flash_kv_word(flash_kv_base[s] + i) != FLASH_KV_ERASED)
+        {
+            return 0U;
+        }
+    }
+    return 1U;
+}
+
+static flash_kv_status_t flash_kv_erase(uint8_t s)
+{
+    flash_kv_iap_t iap = (flash_kv_iap_t)FLASH_KV_IAP_ENTRY;
+    uint32_t cmd[5];
+    uint32_t res[5];
+    uint32_t primask;
+
+    cmd[0] = FLASH_KV_IAP_PREPARE;
+    cmd[1] = flash_kv_sector[s];
+    cmd[2] = flash_kv_sector[s];
+    primask = Critical_Enter();
+    iap(cmd, res);
+    if (res[0] == FLASH_KV_IAP_SUCCESS)
+    {
+        cmd[0] = FLASH_KV_IAP_ERASE;
+        cmd[3] = FLASH_KV_CCLK_KHZ;
+        iap(cmd, res);
+    }
+    Critical_Exit(primask);
+
+    flash_kv_stats.erases++;
+    return ((res[0] == FLASH_KV_IAP_SUCCESS) && (flash_kv_blank(s) != 0U)) ?
+           FLASH_KV_STATUS_OK : FLASH_KV_STATUS_ERROR;
+}
+
+/* Program flash_kv_page at page p of sector s, then verify it */
+static flash_kv_status_t flash_kv_program(uint8_t s, uint32_t p)
+{
+    flash_kv_iap_t iap = (flash_kv_iap_t)FLASH_KV_IAP_ENTRY;
+    uint32_t dst = flash_kv_base[s] + (p * FLASH_KV_PAGE_BYTES);
+    uint32_t cmd[5];
+    uint32_t res[5];
+    uint32_t primask;
+    uint32_t t0;
+    uint32_t us;
+    uint32_t i;
+
+    cmd[0] = FLASH_KV_IAP_PREPARE;
+    cmd[1] = flash_kv_sector[s];
+    cmd[2] = flash_kv_sector[s];
+    primask = Critical_Enter();
+    t0 = Cycles_Now();
+    iap(cmd, res);
+    if (res[0] == FLASH_KV_IAP_SUCCESS)
+    {
+        cmd[0] = FLASH_KV_IAP_COPY;
+        cmd[1] = dst;
+        cmd[2] = (uint32_t)&flash_kv_page[0];
+        cmd[3] = FLASH_KV_PAGE_BYTES;
+        cmd[4] = FLASH_KV_CCLK_KHZ;
+        iap(cmd, res);
+    }
+    us = (Cycles_Now() - t0) / FLASH_KV_CYCLES_PER_US;
+    Critical_Exit(primask);
+
+    flash_kv_stats.pages++;
+    if (us > flash_kv_stats.irq_off_max_us)
+    {
+        flash_kv_stats.irq_off_max_us = us;
+    }
+    if (res[0] != FLASH_KV_IAP_SUCCESS)
+    {
+        return FLASH_KV_STATUS_ERROR;
+    }
+    for (i = 0U; i < FLASH_KV_PAGE_WORDS; i++)
+    {
+        if (flash_kv_word(dst + (4U * i)) != flash_kv_page[i])
+        {
+            return FLASH_KV_STATUS_ERROR;
+        }
+    }
+    return FLASH_KV_STATUS_OK;
+}
+
+/* First record word: key in the low half, CRC of key and value above */
+static uint32_t flash_kv_tag(uint32_t key, uint32_t value)
+{
+    uint8_t b[5];
+
+    b[0] = (uint8_t)key;
+    b[1] = (uint8_t)value;
+    b[2] = (uint8_t)(value >> 8);
+    b[3] = (uint8_t)(value >> 16);
+    b[4] = (uint8_t)(value >> 24);
+    return key | ((uint32_t)Crc16_Ccitt(b, 5U, CRC16_INIT) << 16);
+}
+
+static void flash_kv_page_clear(void)
+{
+    uint32_t i;
+
+    for (i = 0U; i < FLASH_KV_PAGE_WORDS; i++)
+    {
+        flash_kv_page[i] = FLASH_KV_ERASED;
+    }
+    flash_kv_fill = 0U;
+}
+
+static void flash_kv_page_put(uint32_t w0, uint32_t w1)
+{
+    flash_kv_page[2U * flash_kv_fill]        = w0;
+    flash_kv_page[(2U * flash_kv_fill) + 1U] = w1;
+    flash_kv_fill++;
+}
+
+/* Records for the keys in mask, packed from page *p of sector s on.
+   *p advances past every page tried, written or not */
+static flash_kv_status_t flash_kv_emit(uint8_t s, uint32_t *p, uint32_t mask)
+{
+    uint8_t k;
+
+    for (k = 0U; k < FLASH_KV_KEYS; k++)
+    {
+        if ((mask & (1UL << k)) != 0U)
+        {
+            flash_kv_page_put(flash_kv_tag(k, flash_kv_value[k]), flash_kv_value[k]);
+            if (flash_kv_fill == FLASH_KV_PAGE_RECORDS)
+            {
+                (*p)++;
+                if (flash_kv_program(s, *p - 1U) != FLASH_KV_STATUS_OK)
+                {
+                    return FLASH_KV_STATUS_ERROR;
+                }
+                flash_kv_page_clear();
+            }
+        }
+    }
+    if (flash_kv_fill != 0U)
+    {
+        (*p)++;
+        return flash_kv_program(s, *p - 1U);
+    }
+    return FLASH_KV_STATUS_OK;
+}
+
+static uint32_t flash_kv_count(uint32_t mask)
+{
+    uint32_t n = 0U;
+
+    while (mask != 0U)
+    {
+        mask &= mask - 1U;
+        n++;
+    }
+    return n;
+}
+
+/* Generation of sector s, or 0 with *ok clear if its header is not valid */
+static uint32_t flash_kv_header(uint8_t s, uint8_t *ok)
+{
+    uint32_t base = flash_kv_base[s];
+    uint32_t gen  = flash_kv_word(base + 4U);
+
+    *ok = ((flash_kv_word(base) == FLASH_KV_MAGIC) && (flash_kv_word(base + 8U) == ~gen)) ? 1U : 0U;
+    return (*ok != 0U) ? gen : 0U;
+}
+
+/* Rebuild the index from the active sector's log */
+static void flash_kv_replay(void)
+{
+    uint32_t base = flash_kv_base[flash_kv_active];
+    uint32_t p;
+    uint32_t r;
+
+    flash_kv_next_page = FLASH_KV_SECTOR_PAGES;
+    for (p = 1U; p < FLASH_KV_SECTOR_PAGES; p++)
+    {
+        uint32_t page = base + (p * FLASH_KV_PAGE_BYTES);
+
+        if ((flash_kv_word(page) == FLASH_KV_ERASED) && (flash_kv_word(page + 4U) == FLASH_KV_ERASED))
+        {
+            flash_kv_next_page = p;
+            break;
+        }
+        for (r = 0U; r < FLASH_KV_PAGE_RECORDS; r++)
+        {
+            uint32_t w0  = flash_kv_word(page + (r * FLASH_KV_RECORD_BYTES));
+            uint32_t w1  = flash_kv_word(page + (r * FLASH_KV_RECORD_BYTES) + 4U);
+            uint32_t key = w0 & 0xFFFFUL;
+
+            if ((key < FLASH_KV_KEYS) && (flash_kv_tag(key, w1) == w0))
+            {
+                flash_kv_value[key] = w1;
+                flash_kv_present   |= (1UL << key);
+            }
+        }
+    }
+}
+
+flash_kv_status_t Flash_KV_Init(void)
+{
+    uint32_t gen[2];
+    uint8_t  ok[2];
+    uint8_t  s;
+
+    flash_kv_present = 0U;
+    flash_kv_dirty   = 0U;
+    flash_kv_stats.flushes        = 0U;
+    flash_kv_stats.pages          = 0U;
+    flash_kv_stats.compactions    = 0U;
+    flash_kv_stats.erases         = 0U;
+    flash_kv_stats.irq_off_max_us = 0U;
+
+    for (s = 0U; s < 2U; s++)
+    {
+        gen[s] = flash_kv_header(s, &ok[s]);
+    }
+
+    /* Active: the valid sector with the newer generation (wrap-safe) */
+    if ((ok[0] != 0U) && (ok[1] != 0U))
+    {
+        flash_kv_active = ((int32_t)(gen[1] - gen[0]) > 0) ? 1U : 0U;
+    }
+    else
+    {
+        flash_kv_active = (ok[1] != 0U) ? 1U : 0U;
+    }
+    flash_kv_active_valid = ok[flash_kv_active];
+
+    if (flash_kv_active_valid != 0U)
+    {
+        flash_kv_gen = gen[flash_kv_active];
+        flash_kv_replay();
+    }
+    else
+    {
+        /* Nothing stored: the first flush compacts into sector A */
+        flash_kv_active = 1U;
+        flash_kv_gen    = 0U;
+    }
+
+    /* Boot is the time to erase: the spare must be blank for compaction */
+    flash_kv_spare_blank = 0U;
+    return Flash_KV_Maintain();
+}
+
+flash_kv_status_t Flash_KV_Get(uint8_t key, uint32_t *value)
+{
+    if ((key >= FLASH_KV_KEYS) || (value == NULL))
+    {
+        return FLASH_KV_STATUS_INVALID_PARAM;
+    }
+    if ((flash_kv_present & (1UL << key)) == 0U)
+    {
+        return FLASH_KV_STATUS_NOT_FOUND;
+    }
+    *value = flash_kv_value[key];
+    return FLASH_KV_STATUS_OK;
+}
+
+flash_kv_status_t Flash_KV_Set(uint8_t key, uint32_t value)
+{
+    if (key >= FLASH_KV_KEYS)
+    {
+        return FLASH_KV_STATUS_INVALID_PARAM;
+    }
+    if (((flash_kv_present & (1UL << key)) == 0U) || (flash_kv_value[key] != value))
+    {
+        flash_kv_value[key] = value;
+        flash_kv_present   |= (1UL << key);
+        flash_kv_dirty     |= (1UL << key);
+    }
+    return FLASH_KV_STATUS_OK;
+}
+
+flash_kv_status_t Flash_KV_Flush(void)
+{
+    uint32_t pages;
+    uint32_t p;
+    uint8_t  spare;
+    flash_kv_status_t st;
+
+    if (flash_kv_dirty == 0U)
+    {
+        return FLASH_KV_STATUS_OK;
+    }
+    flash_kv_stats.flushes++;
+    pages = (flash_kv_count(flash_kv_dirty) + FLASH_KV_PAGE_RECORDS - 1U) / FLASH_KV_PAGE_RECORDS;
+
+    /* Append the changed keys */
+    if ((flash_kv_active_valid != 0U) && ((flash_kv_next_page + pages) <= FLASH_KV_SECTOR_PAGES))
+    {
+        flash_kv_page_clear();
+        st = flash_kv_emit(flash_kv_active, &flash_kv_next_page, flash_kv_dirty);
+        if (st == FLASH_KV_STATUS_OK)
+        {
+            flash_kv_dirty = 0U;
+        }
+        return st;
+    }
+
+    /* Full: every live key into the spare sector, then its header. Until
+       the header is in, the current sector stays the valid one */
+    spare = (uint8_t)(flash_kv_active ^ 1U);
+    if (flash_kv_spare_blank == 0U)
+    {
+        return FLASH_KV_STATUS_FULL;
+    }
+    flash_kv_spare_blank = 0U;
+    flash_kv_page_clear();
+    p  = 1U;
+    st = flash_kv_emit(spare, &p, flash_kv_present);
+    if (st != FLASH_KV_STATUS_OK)
+    {
+        return st;
+    }
+    flash_kv_page_clear();
+    flash_kv_page_put(FLASH_KV_MAGIC, flash_kv_gen + 1U);
+    flash_kv_page_put(~(flash_kv_gen + 1U), FLASH_KV_ERASED);
+    st = flash_kv_program(spare, 0U);
+    if (st != FLASH_KV_STATUS_OK)
+    {
+        return st;
+    }
+
+    flash_kv_active       = spare;
+    flash_kv_active_valid = 1U;
+    flash_kv_gen++;
+    flash_kv_next_page    = p;
+    flash_kv_dirty        = 0U;
+    flash_kv_stats.compactions++;
+    return FLASH_KV_STATUS_OK;
+}
+
+flash_kv_status_t Flash_KV_Maintain(void)
+{
+    uint8_t spare = (uint8_t)(flash_kv_active ^ 1U);
+
+    if (flash_kv_spare_blank == 0U)
+    {
+        if ((flash_kv_blank(spare) == 0U) && (flash_kv_erase(spare) != FLASH_KV_STATUS_OK))
+        {
+            return FLASH_KV_STATUS_ERROR;
+        }
+        flash_kv_spare_blank = 1U;
+    }
+    return FLASH_KV_STATUS_OK;
+}
+
+void Flash_KV_Get_Stats(flash_kv_stats_t *out)
+{
+    if (out != NULL)
+    {
+        *out = flash_kv_stats;
+    }
+}
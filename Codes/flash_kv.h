@@ -0,0 +1,104 @@
+/*
+ * File: flash_kv.h
+ * Purpose: Log-structured key/value store in internal flash via IAP (MISRA C:2012 aligned)
+ *
+ * EEPROM emulation for boards without the external 24LCxx. Two 32 KB
+ * sectors (28 and 29, the top 64 KB, which the linker script must keep
+ * free of code) take turns as the active log. A record is 8 bytes: the key
+ * with a CRC-16 of key and value, then the value; the newest record of a
+ * key wins.
+ * Page 0 of a sector holds only its header (magic and generation), so
+ * the sector with the higher generation is the active one. Compaction
+ * programs the header last: one cut short by a power loss leaves a
+ * sector without a header, and the previous sector stays active.
+ *
+ * Flash_KV_Set() only updates the RAM index, which also serves every read
+ * in O(1). Flash_KV_Flush() packs all changed keys into as few 256-byte
+ * pages as possible: one IAP program call per page, each page written
+ * once. When the active sector is full, the live values are compacted into
+ * the spare sector under a new generation.
+ *
+ * Interrupt latency: while IAP programs or erases, flash cannot be read,
+ * so every IAP call runs with interrupts masked (the vectors and handlers
+ * are in flash). A page program masks them for at most
+ * FLASH_KV_PROG_MAX_US; that is the only IAP work done at run time. A
+ * sector erase masks them for up to FLASH_KV_ERASE_MAX_US, so erases are
+ * only done by Flash_KV_Init() before the scheduler starts and by
+ * Flash_KV_Maintain(), which the application calls only when stalling the
+ * outputs is acceptable (e.g. vehicle stopped). Peripherals keep running
+ * meanwhile: DMA streams and PWM are unaffected; TIMER0 deadlines fire
+ * late by up to the masked time and the time-based consumers catch up.
+ * IAP also uses the top 32 bytes of on-chip RAM, which the stack must not
+ * reach.
+ */
+
+#ifndef FLASH_KV_H
+#define FLASH_KV_H
+
+#include <stdint.h>
+
+/* Status codes for flash store APIs */
+typedef enum
+{
+    FLASH_KV_STATUS_OK = 0,
+    FLASH_KV_STATUS_INVALID_PARAM = 1,
+    FLASH_KV_STATUS_NOT_FOUND = 2,
+    FLASH_KV_STATUS_FULL = 3,        /* needs Flash_KV_Maintain() first; values kept */
+    FLASH_KV_STATUS_ERROR = 4        /* IAP error or verify mismatch */
+} flash_kv_status_t;
+
+/* Keys are 0..FLASH_KV_KEYS-1 */
+#define FLASH_KV_KEYS                     (32U)
+
+/* Sectors and their geometry */
+#define FLASH_KV_SECTOR_A                 (28U)
+#define FLASH_KV_SECTOR_B                 (29U)
+#define FLASH_KV_SECTOR_A_BASE            (0x00070000UL)
+#define FLASH_KV_SECTOR_B_BASE            (0x00078000UL)
+#define FLASH_KV_SECTOR_BYTES             (0x8000UL)
+#define FLASH_KV_PAGE_BYTES               (256U)
+#define FLASH_KV_RECORD_BYTES             (8U)
+#define FLASH_KV_PAGE_RECORDS             (FLASH_KV_PAGE_BYTES / FLASH_KV_RECORD_BYTES)
+#define FLASH_KV_SECTOR_PAGES             (FLASH_KV_SECTOR_BYTES / FLASH_KV_PAGE_BYTES)
+
+#define FLASH_KV_MAGIC                    (0x32564B46UL)   /* "FKV2" */
+
+/* IAP entry point and commands (UM10360 chapter 32) */
+#define FLASH_KV_IAP_ENTRY                (0x1FFF1FF1UL)
+#define FLASH_KV_IAP_PREPARE              (50UL)
+#define FLASH_KV_IAP_COPY                 (51UL)
+#define FLASH_KV_IAP_ERASE                (52UL)
+#define FLASH_KV_IAP_BLANK_CHECK          (53UL)
+#define FLASH_KV_IAP_SUCCESS              (0UL)
+#define FLASH_KV_IAP_SECTOR_NOT_BLANK     (8UL)
+
+/* Worst-case interrupt masking per IAP call (LPC1768 datasheet t_prog
+   and t_er maxima, plus the IAP call overhead) */
+#define FLASH_KV_PROG_MAX_US              (1100U)
+#define FLASH_KV_ERASE_MAX_US             (105000U)
+
+/* Statistics since power-up */
+typedef struct
+{
+    uint32_t flushes;
+    uint32_t pages;            /* IAP program calls */
+    uint32_t compactions;
+    uint32_t erases;
+    uint32_t irq_off_max_us;   /* longest run-time (program) masking measured */
+} flash_kv_stats_t;
+
+/* Public API (main context) */
+/* Find the active sector and build the index; erases the spare sector if
+   needed, so call before the scheduler starts */
+flash_kv_status_t Flash_KV_Init(void);
+flash_kv_status_t Flash_KV_Get(uint8_t key, uint32_t *value);
+/* RAM only; written by the next Flash_KV_Flush() */
+flash_kv_status_t Flash_KV_Set(uint8_t key, uint32_t value);
+/* Write every changed key; masks interrupts up to FLASH_KV_PROG_MAX_US per page */
+flash_kv_status_t Flash_KV_Flush(void);
+/* Erase the spare sector if a compaction left it dirty; masks interrupts
+   up to FLASH_KV_ERASE_MAX_US */
+flash_kv_status_t Flash_KV_Maintain(void);
+void              Flash_KV_Get_Stats(flash_kv_stats_t *out);
+
+#endif /* FLASH_KV_H */
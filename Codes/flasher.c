@@ -0,0 +1,177 @@
+/*
+ * File: flasher.c
+ * Purpose: Beat timeline shared by the turn lamps and the tick sound.
+ * Notes: Beats are computed from the anchor, never accumulated, so lamp and
+ *        sound cannot drift apart. The beat deadline runs in TIMER0 ISR
+ *        context and is the only other user of the state it reads; Start
+ *        and Stop update it under a critical section.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "critical.h"
+#include "evq.h"
+#include "systime.h"
+#include "timer.h"
+#include "sched.h"
+#include "flasher.h"
+
+static deadline_t flasher_beat;
+static uint64_t   flasher_anchor_us;
+static uint64_t   flasher_next_us;      /* next beat to post */
+static uint32_t   flasher_period_us;
+static uint8_t    flasher_running;
+
+/* Skew pairing: latest unmatched edge of each kind, by beat index */
+static uint64_t       flasher_lamp_us;
+static uint64_t       flasher_sound_us;
+static uint32_t       flasher_lamp_beat;
+static uint32_t       flasher_sound_beat;
+static uint8_t        flasher_lamp_valid;
+static uint8_t        flasher_sound_valid;
+static flasher_skew_t flasher_skew;
+
+/* TIMER0 ISR context: announce the beat, then arm the following one */
+static void flasher_beat_cb(void *ctx)
+{
+    uint64_t now = time_now_us();
+
+    (void)ctx;
+    (void)EvQ_Post(&timer_evq, (uint8_t)EVT_FLASH_BEAT, 0U);
+    Sched_Kick();
+
+    do
+    {
+        flasher_next_us += flasher_period_us;   /* skip beats a long ISR overran */
+    } while (flasher_next_us <= now);
+    Deadline_Set_At(&flasher_beat, flasher_next_us);
+    (void)Deadline_Await(&flasher_beat, flasher_beat_cb, NULL);
+}
+
+void Flasher_Init(void)
+{
+    Flasher_Stop();
+    Flasher_Reset_Skew();
+}
+
+flasher_status_t Flasher_Start(uint16_t period_ms, uint64_t now_us)
+{
+    uint32_t primask;
+
+    if (period_ms == 0U)
+    {
+        return FLASHER_STATUS_INVALID_PARAM;
+    }
+
+    primask = Critical_Enter();
+    flasher_anchor_us = now_us;
+    flasher_next_us   = now_us;
+    flasher_period_us = (uint32_t)period_ms * 1000U;
+    flasher_running   = 1U;
+    /* Beat 0 is due at once, so its event follows straight away */
+    Deadline_Set_At(&flasher_beat, flasher_next_us);
+    (void)Deadline_Await(&flasher_beat, flasher_beat_cb, NULL);
+    Critical_Exit(primask);
+
+    flasher_lamp_valid  = 0U;
+    flasher_sound_valid = 0U;
+    return FLASHER_STATUS_OK;
+}
+
+void Flasher_Stop(void)
+{
+    uint32_t primask = Critical_Enter();
+
+    Deadline_Cancel(&flasher_beat);
+    flasher_running = 0U;
+    Critical_Exit(primask);
+}
+
+uint8_t Flasher_Running(void)
+{
+    return flasher_running;
+}
+
+uint32_t Flasher_Period_Us(void)
+{
+    return flasher_period_us;
+}
+
+uint64_t Flasher_Beat_Start_Us(uint64_t t_us)
+{
+    if ((flasher_running == 0U) || (t_us <= flasher_anchor_us))
+    {
+        return flasher_anchor_us;
+    }
+    return t_us - ((t_us - flasher_anchor_us) % flasher_period_us);
+}
+
+/* Index of the beat nearest t_us, so an edge slightly early still pairs */
+static uint32_t flasher_nearest_beat(uint64_t t_us)
+{
+    if (t_us <= flasher_anchor_us)
+    {
+        return 0U;
+    }
+    return (uint32_t)((t_us - flasher_anchor_us + (flasher_period_us / 2U)) / flasher_period_us);
+}
+
+static void flasher_pair(void)
+{
+    int64_t  skew;
+    uint32_t mag;
+
+    if ((flasher_lamp_valid == 0U) || (flasher_sound_valid == 0U) ||
+        (flasher_lamp_beat != flasher_sound_beat))
+    {
+        return;
+    }
+
+    skew = (int64_t)flasher_sound_us - (int64_t)flasher_lamp_us;
+    mag  = (uint32_t)((skew < 0) ? -skew : skew);
+    flasher_skew.last_us = (int32_t)skew;
+    if (mag > flasher_skew.max_us)
+    {
+        flasher_skew.max_us = mag;
+    }
+    flasher_skew.samples++;
+    flasher_lamp_valid  = 0U;
+    flasher_sound_valid = 0U;
+}
+
+void Flasher_Mark_Lamp(uint64_t t_us)
+{
+    if (flasher_running != 0U)
+    {
+        flasher_lamp_us    = t_us;
+        flasher_lamp_beat  = flasher_nearest_beat(t_us);
+        flasher_lamp_valid = 1U;
+        flasher_pair();
+    }
+}
+
+void Flasher_Mark_Sound(uint64_t t_us)
+{
+    if (flasher_running != 0U)
+    {
+        flasher_sound_us    = t_us;
+        flasher_sound_beat  = flasher_nearest_beat(t_us);
+        flasher_sound_valid = 1U;
+        flasher_pair();
+    }
+}
+
+void Flasher_Get_Skew(flasher_skew_t *s)
+{
+    if (s != NULL)
+    {
+        *s = flasher_skew;
+    }
+}
+
+void Flasher_Reset_Skew(void)
+{
+    flasher_skew.last_us = 0;
+    flasher_skew.max_us  = 0U;
+    flasher_skew.samples = 0U;
+}
@@ -0,0 +1,53 @@
+/*
+ * File: flasher.h
+ * Purpose: Shared beat for the turn lamps and the tick sound (MISRA C:2012 aligned)
+ *
+ * A relay flasher clicks exactly when the lamps switch. Here one beat
+ * timeline (anchor + n * period) is the phase reference for both: the
+ * indicator animation pins its frame steps to it and beat-locked chimes
+ * restart on every beat. Each beat posts EVT_FLASH_BEAT from the TIMER0 ISR,
+ * so the lamp frame and the chime step are re-evaluated in the same
+ * scheduler pass and the tick lands within microseconds of the lamp edge.
+ *
+ * Skew instrumentation: the lamp owner marks when a lamp edge is latched,
+ * the audio arbiter marks when a beat-locked click starts; edges are paired
+ * by nearest beat and the difference is kept as a statistic.
+ */
+
+#ifndef FLASHER_H
+#define FLASHER_H
+
+#include <stdint.h>
+
+/* Status codes for flasher APIs */
+typedef enum
+{
+    FLASHER_STATUS_OK = 0,
+    FLASHER_STATUS_INVALID_PARAM = 1
+} flasher_status_t;
+
+/* Lamp-to-sound skew since the last reset */
+typedef struct
+{
+    int32_t  last_us;    /* sound edge minus lamp edge, latest pair */
+    uint32_t max_us;     /* largest magnitude seen */
+    uint32_t samples;    /* pairs measured */
+} flasher_skew_t;
+
+/* Public API (main context unless noted) */
+void             Flasher_Init(void);
+/* Restart the beat: beat 0 at now_us, then one every period_ms */
+flasher_status_t Flasher_Start(uint16_t period_ms, uint64_t now_us);
+void             Flasher_Stop(void);
+uint8_t          Flasher_Running(void);
+uint32_t         Flasher_Period_Us(void);
+/* Time of the latest beat at or before t_us (the anchor if t_us precedes it) */
+uint64_t         Flasher_Beat_Start_Us(uint64_t t_us);
+
+/* Skew instrumentation */
+void             Flasher_Mark_Lamp(uint64_t t_us);
+void             Flasher_Mark_Sound(uint64_t t_us);
+void             Flasher_Get_Skew(flasher_skew_t *s);
+void             Flasher_Reset_Skew(void);
+
+#endif /* FLASHER_H */
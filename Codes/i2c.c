@@ -0,0 +1,198 @@
+/*
+ * File: i2c.c
+ * Purpose: I2C0 master state machine driven by the status codes in I2STAT.
+ * Notes: The transfer owns the bus from START to STOP; completion is
+ *        reported once, after STOP has been requested, so the callback may
+ *        start the next transfer straight away.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "critical.h"
+#include "i2c.h"
+
+/* Master status codes (UM10360 table 399/400) */
+#define I2C_ST_BUS_ERROR      (0x00UL)
+#define I2C_ST_START          (0x08UL)
+#define I2C_ST_RESTART        (0x10UL)
+#define I2C_ST_SLAW_ACK       (0x18UL)
+#define I2C_ST_SLAW_NACK      (0x20UL)
+#define I2C_ST_DATA_TX_ACK    (0x28UL)
+#define I2C_ST_DATA_TX_NACK   (0x30UL)
+#define I2C_ST_ARB_LOST       (0x38UL)
+#define I2C_ST_SLAR_ACK       (0x40UL)
+#define I2C_ST_SLAR_NACK      (0x48UL)
+#define I2C_ST_DATA_RX_ACK    (0x50UL)
+#define I2C_ST_DATA_RX_NACK   (0x58UL)
+
+static const i2c_xfer_t *i2c_xfer;
+static i2c_done_cb_t     i2c_done_cb;
+static volatile uint8_t  i2c_busy = 0U;
+static uint16_t          i2c_tx_pos;     /* over head, then data */
+static uint16_t          i2c_rx_pos;
+static uint8_t           i2c_reading;    /* address phase is SLA+R */
+
+void I2C_Init(void)
+{
+    /* 1) Power, clock from the plan, pins */
+    LPC_SC->PCONP    |= PCONP_PCI2C0_MASK;
+    LPC_SC->PCLKSEL0 &= ~PCLKSEL0_PCLK_I2C0_MASK;
+    LPC_SC->PCLKSEL0 |=  PCLKSEL0_PCLK_I2C0_PLAN;
+    LPC_PINCON->PINSEL1 = (LPC_PINCON->PINSEL1 & ~PINSEL1_I2C0_MASK) | PINSEL1_I2C0_FUNC;
+
+    /* 2) Master only: clear every control flag, set the rate, enable */
+    LPC_I2C0->CONCLR = I2C_CON_AA | I2C_CON_SI | I2C_CON_STA | I2C_CON_EN;
+    LPC_I2C0->SCLH   = I2C_SCL_HALF;
+    LPC_I2C0->SCLL   = I2C_SCL_HALF;
+    LPC_I2C0->CONSET = I2C_CON_EN;
+
+    i2c_busy = 0U;
+    NVIC_EnableIRQ(I2C0_IRQn);
+}
+
+i2c_status_t I2C_Start(const i2c_xfer_t *x, i2c_done_cb_t done_cb)
+{
+    uint32_t primask;
+
+    if ((x == NULL) || (x->addr7 > 0x7FU) ||
+        ((x->head == NULL) && (x->head_len != 0U)) ||
+        ((x->data == NULL) && (x->data_len != 0U)) ||
+        ((x->rx == NULL) && (x->rx_len != 0U)))
+    {
+        return I2C_STATUS_INVALID_PARAM;
+    }
+
+    primask = Critical_Enter();
+    if (i2c_busy != 0U)
+    {
+        Critical_Exit(primask);
+        return I2C_STATUS_BUSY;
+    }
+    i2c_busy    = 1U;
+    i2c_xfer    = x;
+    i2c_done_cb = done_cb;
+    i2c_tx_pos  = 0U;
+    i2c_rx_pos  = 0U;
+    /* A read-only transfer addresses the device for reading at once */
+    i2c_reading = ((x->head_len == 0U) && (x->data_len == 0U) && (x->rx_len != 0U)) ? 1U : 0U;
+    LPC_I2C0->CONSET = I2C_CON_STA;
+    Critical_Exit(primask);
+
+    return I2C_STATUS_OK;
+}
+
+uint8_t I2C_Busy(void)
+{
+    return i2c_busy;
+}
+
+static void i2c_finish(i2c_status_t status)
+{
+    i2c_done_cb_t cb = i2c_done_cb;
+
+    LPC_I2C0->CONSET = I2C_CON_STO;
+    LPC_I2C0->CONCLR = I2C_CON_SI | I2C_CON_STA | I2C_CON_AA;
+    i2c_busy = 0U;
+    if (cb != NULL)
+    {
+        cb(status);
+    }
+}
+
+/* Next byte of head + data; returns 0 when both are sent */
+static uint8_t i2c_next_tx(uint8_t *b)
+{
+    const i2c_xfer_t *x = i2c_xfer;
+
+    if (i2c_tx_pos < x->head_len)
+    {
+        *b = x->head[i2c_tx_pos];
+    }
+    else if (i2c_tx_pos < (uint16_t)(x->head_len + x->data_len))
+    {
+        *b = x->data[i2c_tx_pos - x->head_len];
+    }
+    else
+    {
+        return 0U;
+    }
+    i2c_tx_pos++;
+    return 1U;
+}
+
+void I2C0_IRQHandler(void)
+{
+    const i2c_xfer_t *x = i2c_xfer;
+    uint32_t st = LPC_I2C0->STAT & 0xF8UL;
+    uint8_t  b;
+
+    switch (st)
+    {
+    case I2C_ST_START:
+    case I2C_ST_RESTART:
+        LPC_I2C0->DAT    = ((uint32_t)x->addr7 << 1) | (uint32_t)i2c_reading;
+        LPC_I2C0->CONCLR = I2C_CON_STA | I2C_CON_SI;
+        break;
+
+    case I2C_ST_SLAW_ACK:
+    case I2C_ST_DATA_TX_ACK:
+        if (i2c_next_tx(&b) != 0U)
+        {
+            LPC_I2C0->DAT    = b;
+            LPC_I2C0->CONCLR = I2C_CON_SI;
+        }
+        else if (x->rx_len != 0U)
+        {
+            i2c_reading      = 1U;
+            LPC_I2C0->CONSET = I2C_CON_STA;   /* repeated START */
+            LPC_I2C0->CONCLR = I2C_CON_SI;
+        }
+        else
+        {
+            i2c_finish(I2C_STATUS_OK);
+        }
+        break;
+
+    case I2C_ST_SLAR_ACK:
+        /* ACK every byte but the last */
+        if (x->rx_len > 1U)
+        {
+            LPC_I2C0->CONSET = I2C_CON_AA;
+        }
+        else
+        {
+            LPC_I2C0->CONCLR = I2C_CON_AA;
+        }
+        LPC_I2C0->CONCLR = I2C_CON_SI;
+        break;
+
+    case I2C_ST_DATA_RX_ACK:
+        x->rx[i2c_rx_pos] = (uint8_t)LPC_I2C0->DAT;
+        i2c_rx_pos++;
+        if ((uint16_t)(i2c_rx_pos + 1U) >= x->rx_len)
+        {
+            LPC_I2C0->CONCLR = I2C_CON_AA;
+        }
+        LPC_I2C0->CONCLR = I2C_CON_SI;
+        break;
+
+    case I2C_ST_DATA_RX_NACK:
+        x->rx[i2c_rx_pos] = (uint8_t)LPC_I2C0->DAT;
+        i2c_rx_pos++;
+        i2c_finish(I2C_STATUS_OK);
+        break;
+
+    case I2C_ST_SLAW_NACK:
+    case I2C_ST_DATA_TX_NACK:
+    case I2C_ST_SLAR_NACK:
+        i2c_finish(I2C_STATUS_NACK);
+        break;
+
+    case I2C_ST_ARB_LOST:
+    case I2C_ST_BUS_ERROR:
+    default:
+        i2c_finish(I2C_STATUS_ERROR);
+        break;
+    }
+}
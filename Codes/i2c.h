@@ -0,0 +1,78 @@
+/*
+ * File: i2c.h
+ * Purpose: Interrupt-driven I2C0 master (MISRA C:2012 aligned)
+ *
+ * One transfer at a time: an optional two-part write (a short header such
+ * as a memory address, then a data buffer, so callers never copy) followed
+ * by an optional read after a repeated START. Each bus state change is one
+ * I2C0 interrupt; the CPU never waits on the bus. A transfer with nothing
+ * to write or read only addresses the device, which is how an EEPROM is
+ * ACK-polled for the end of its write cycle.
+ */
+
+#ifndef I2C_H
+#define I2C_H
+
+#include <stdint.h>
+#include "clock_plan.h"
+
+/* Status codes for I2C APIs and completions */
+typedef enum
+{
+    I2C_STATUS_OK = 0,
+    I2C_STATUS_INVALID_PARAM = 1,
+    I2C_STATUS_BUSY = 2,
+    I2C_STATUS_NACK = 3,        /* device did not acknowledge */
+    I2C_STATUS_ERROR = 4        /* bus error or lost arbitration */
+} i2c_status_t;
+
+/* Power/clock: PCONP bit 7, PCLKSEL0 bits [15:14] */
+#define PCONP_PCI2C0_MASK                 (1UL << 7)
+#define PCLKSEL0_PCLK_I2C0_MASK           (3UL << 14)
+#define PCLKSEL0_PCLK_I2C0_PLAN           (CLOCK_PLAN_PCLKSEL_BITS << 14)
+
+/* P0.27 SDA0, P0.28 SCL0 (PINSEL1 = 01); open-drain pins, no PINMODE */
+#define PINSEL1_I2C0_MASK                 ((3UL << 22) | (3UL << 24))
+#define PINSEL1_I2C0_FUNC                 ((1UL << 22) | (1UL << 24))
+
+/* I2CONSET / I2CONCLR bits */
+#define I2C_CON_AA                        (1UL << 2)
+#define I2C_CON_SI                        (1UL << 3)
+#define I2C_CON_STO                       (1UL << 4)
+#define I2C_CON_STA                       (1UL << 5)
+#define I2C_CON_EN                        (1UL << 6)
+
+/* SCL rate; SCLH = SCLL = half period in PCLK cycles, rounded up */
+#ifndef I2C_SCL_HZ
+#define I2C_SCL_HZ                        (400000UL)
+#endif
+#define I2C_SCL_HALF                      ((CLOCK_PLAN_PCLK_HZ + (2UL * I2C_SCL_HZ) - 1UL) / (2UL * I2C_SCL_HZ))
+
+#if (I2C_SCL_HALF < 4UL)
+#error "i2c: SCLH/SCLL below the minimum of 4"
+#endif
+
+/* Transfer description, owned by the caller until completion */
+typedef struct
+{
+    const uint8_t *head;        /* written first (may be NULL) */
+    const uint8_t *data;        /* written after head (may be NULL) */
+    uint8_t       *rx;          /* read after a repeated START (may be NULL) */
+    uint16_t       head_len;
+    uint16_t       data_len;
+    uint16_t       rx_len;
+    uint8_t        addr7;
+} i2c_xfer_t;
+
+/* Completion callback, invoked from I2C0 ISR context */
+typedef void (*i2c_done_cb_t)(i2c_status_t status);
+
+/* Public API */
+void         I2C_Init(void);
+/* Start a transfer; BUSY if one is still in flight. Callable from any context */
+i2c_status_t I2C_Start(const i2c_xfer_t *x, i2c_done_cb_t done_cb);
+uint8_t      I2C_Busy(void);
+
+void I2C0_IRQHandler(void);
+
+#endif /* I2C_H */
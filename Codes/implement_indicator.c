@@ -1,122 +1,67 @@
-/* Non-blocking indicator patterns using timer interrupt flags.
+/* Non-blocking indicator patterns paced by timer tick events.
+ * Each direction is a keyframe table in anim.c played by one generic player:
  * Direction 1: fill lower nibble from MSB->LSB (bits 3..0).
  * Direction 2: fill upper nibble from LSB->MSB (bits 4..7).
  * Direction 3: center-out across both (3&4 -> 2&5 -> 1&6 -> 0&7 -> clear).
+ * Frame steps are pinned to the flasher beat, which also paces the tick sound.
  */
-#include "indicator.h"
 #include <stdint.h>
-#include "timer.h"
+#include <stddef.h>
+#include "lamp_fb.h"
+#include "evq.h"
+#include "systime.h"
+#include "anim.h"
+#include "flasher.h"
+#include "implement_indicator.h"
 
-extern volatile uint8_t LED1_flag; /* toggles every 1 s in TIMER0 IRQ */
-extern volatile uint8_t LED2_flag; /* toggles every 1.35 s in TIMER0 IRQ */
+/* Direction -> animation; NULL or unknown directions blank the turn lamps */
+static const anim_t *const indicator_anims[] =
+{
+    NULL,
+    &Anim_Left_Fill,
+    &Anim_Right_Fill,
+    &Anim_Center_Out
+};
+
+#define INDICATOR_NUM_DIRS  ((uint8_t)(sizeof(indicator_anims) / sizeof(indicator_anims[0])))
+
+static anim_player_t indicator_player = { NULL, 0U, 0U, 0U, 0U, LAMPFB_BYTE_TURN };
+
+void Indicator_On_Event(const evt_t *e)
+{
+    Anim_On_Event(&indicator_player, e);
+    Anim_Update(&indicator_player, time_now_us());
+}
 
 void Indicator(uint8_t direction)
 {
-    /* Persist state across calls */
-    static uint8_t prev_flag1 = 0U;  /* edge detect for LED1_flag */
-    static uint8_t prev_flag2 = 0U;  /* edge detect for LED2_flag */
-    static uint8_t last_dir   = 0U;  /* reset state on change */
-    static int8_t  idx1       = 3;   /* dir1 index: 3 -> 0 */
-    static int8_t  idx2       = 4;   /* dir2 index: 4 -> 7 */
-    static uint8_t step3      = 0U;  /* dir3 step: 0..3 then clear */
-    static uint8_t pattern    = 0U;  /* 74HC595 output pattern */
+    const anim_t *a = (direction < INDICATOR_NUM_DIRS) ? indicator_anims[direction] : NULL;
 
-    /* Reset per-direction state if direction changed */
-    if (direction != last_dir)
+    if (a != NULL)
     {
-        last_dir   = direction;
-        prev_flag1 = LED1_flag; /* avoid immediate step on change */
-        prev_flag2 = LED2_flag;
-        pattern    = 0U;
-        HC595_Load(pattern);
-        idx1 = 3; idx2 = 4; step3 = 0U;
-    }
+        uint64_t now_us = time_now_us();
 
-    if (direction == 1U)
-    {
-        uint8_t curr = LED1_flag;
-        if (curr != prev_flag1)
+        /* Restarts only when the direction changes, together with the beat
+           so lamp and tick sound share one phase. The first step is due at
+           beat 0, so the first lit frame shows at once (switch response);
+           otherwise shows whichever frame is due now */
+        if (a != indicator_player.anim)
         {
-            prev_flag1 = curr;
-            if (idx1 >= 0)
-            {
-                pattern |= (uint8_t)(1U << idx1);
-                HC595_Load(pattern);
-                idx1--;
-            }
-            else
-            {
-                idx1    = 3;
-                pattern = 0U;
-                HC595_Load(pattern);
-            }
+            Anim_Play(&indicator_player, a, now_us);
+            (void)Flasher_Start(a->step_ms, now_us);
+            Anim_Lock(&indicator_player, now_us); /* first lit frame at once */
         }
+        Anim_Update(&indicator_player, now_us);
     }
-    else if (direction == 2U)
+    else if (indicator_player.anim != NULL)
     {
-        uint8_t curr = LED2_flag;
-        if (curr != prev_flag2)
-        {
-            prev_flag2 = curr;
-            if (idx2 <= 7)
-            {
-                pattern |= (uint8_t)(1U << idx2);
-                HC595_Load(pattern);
-                idx2++;
-            }
-            else
-            {
-                idx2    = 4;
-                pattern = 0U;
-                HC595_Load(pattern);
-            }
-        }
-    }
-    else if (direction == 3U)
-    {
-        /* Use 1-second pace on center-out combined pattern */
-        uint8_t curr = LED1_flag;
-        if (curr != prev_flag1)
-        {
-            prev_flag1 = curr;
-            switch (step3)
-            {
-                case 0U:
-                    /* middle pair: bits 3 and 4 */
-                    pattern |= (uint8_t)((1U << 3) | (1U << 4));
-                    HC595_Load(pattern);
-                    step3 = 1U;
-                    break;
-                case 1U:
-                    /* extend: add bits 2 and 5 */
-                    pattern |= (uint8_t)((1U << 2) | (1U << 5));
-                    HC595_Load(pattern);
-                    step3 = 2U;
-                    break;
-                case 2U:
-                    /* extend: add bits 1 and 6 */
-                    pattern |= (uint8_t)((1U << 1) | (1U << 6));
-                    HC595_Load(pattern);
-                    step3 = 3U;
-                    break;
-                case 3U:
-                    /* extend: add bits 0 and 7 -> all on */
-                    pattern |= (uint8_t)((1U << 0) | (1U << 7));
-                    HC595_Load(pattern);
-                    step3 = 4U;
-                    break;
-                default:
-                    /* clear and restart */
-                    pattern = 0U;
-                    HC595_Load(pattern);
-                    step3 = 0U;
-                    break;
-            }
-        }
+        Anim_Stop(&indicator_player);
+        Flasher_Stop();
+        LampFB_Write(LAMPFB_BYTE_TURN, 0xFFU, 0U);
     }
     else
     {
-        /* Unknown direction: keep outputs as-is */
+        /* Already blank */
         (void)0;
     }
 }
@@ -1,2 +1,5 @@
 #include <stdint.h>
+#include "evq.h"
+/* Feed timer events; the frame shown follows the tick / flasher beat phase */
+void Indicator_On_Event(const evt_t *e);
 void Indicator(uint8_t direction);
@@ -1,25 +1,129 @@
 /*
  * File: indicator.c
  * Purpose: Configure SSP0 and drive 74HC595 shift register for indicators.
- * Notes: MISRA C:2012 aligned; no logic changes from original implementation.
+ * Notes: MISRA C:2012 aligned. Loads never wait on the bus: single bytes
+ *        complete in SSP0_IRQHandler, daisy-chain frames via GPDMA.
  */
 
 #include <LPC17xx.h>
 #include <stdint.h>
+#include <stddef.h>
 #include "indicator.h"
+#include "dma.h"
+
+/* Asynchronous loader state, shared between main context and SSP0 ISR */
+static volatile uint8_t         hc595_busy          = 0U;
+static volatile uint8_t         hc595_pending       = 0U;  /* latest value queued while busy */
+static volatile uint8_t         hc595_pending_valid = 0U;
+static volatile hc595_done_cb_t hc595_done_cb       = NULL;
+static volatile uint8_t         hc595_frame         = 0U;  /* GPDMA frame in flight */
+
+/* Sink for the bytes echoed back while a frame is streamed out */
+static volatile uint8_t hc595_rx_sink;
+
+/* Block both completion paths (SSP0 receive timeout and GPDMA) */
+static void hc595_lock(void)
+{
+    NVIC_DisableIRQ(SSP0_IRQn);
+    NVIC_DisableIRQ(DMA_IRQn);
+}
+
+static void hc595_unlock(void)
+{
+    NVIC_EnableIRQ(DMA_IRQn);
+    NVIC_EnableIRQ(SSP0_IRQn);
+}
+
+static void hc595_latch(void)
+{
+    LPC_GPIO0->FIOSET = GPIO0_P0_16_MASK;  /* ST_CP HIGH */
+    LPC_GPIO0->FIOCLR = GPIO0_P0_16_MASK;  /* ST_CP LOW  */
+}
+
+static void hc595_start(uint8_t value, hc595_done_cb_t done_cb)
+{
+    hc595_done_cb = done_cb;
+    hc595_busy    = 1U;
+    LPC_SSP0->DR  = value;  /* byte enters TX FIFO; shifting runs in hardware */
+}
+
+/* Common tail of a byte or frame load: latch (unless aborted), release,
+   start parked byte */
+static void hc595_finish(hc595_status_t status)
+{
+    hc595_done_cb_t done_cb;
+
+    /* Last bit is in the shift register: latch it to the outputs */
+    while ((LPC_SSP0->SR & SSP_SR_BSY_MASK) != 0UL) {
+        /* at most half an SCK period after the RX sample */
+    }
+    if (status == HC595_STATUS_OK)
+    {
+        hc595_latch();
+    }
+
+    done_cb       = hc595_done_cb;
+    hc595_done_cb = NULL;
+    hc595_busy    = 0U;
+
+    if (hc595_pending_valid != 0U)
+    {
+        hc595_pending_valid = 0U;
+        hc595_start(hc595_pending, NULL);
+    }
+
+    if (done_cb != NULL)
+    {
+        done_cb(status);
+    }
+}
+
+/* RX channel terminal count: every byte of the frame has been shifted.
+   An error on either channel ends the frame here too: it will never reach
+   its terminal count, so both channels are stopped and the partly shifted
+   chain is released without a latch */
+static void hc595_frame_done(uint8_t channel, dma_status_t status)
+{
+    (void)channel;
+
+    if (hc595_frame == 0U)
+    {
+        return;   /* already ended by the other channel in the same IRQ */
+    }
+    hc595_frame = 0U;
+
+    LPC_SSP0->DMACR = 0UL;
+    if (status != DMA_STATUS_OK)
+    {
+        DMA_CHANNEL(DMA_CH_HC595_TX)->CConfig &= ~DMA_CCFG_E_MASK;
+        DMA_CHANNEL(DMA_CH_HC595_RX)->CConfig &= ~DMA_CCFG_E_MASK;
+        while ((LPC_SSP0->SR & SSP_SR_BSY_MASK) != 0UL) {
+            /* let the byte on the wire finish */
+        }
+        while ((LPC_SSP0->SR & SSP_SR_RNE_MASK) != 0UL)
+        {
+            (void)LPC_SSP0->DR;
+        }
+    }
+    LPC_SSP0->ICR   = (SSP_ICR_RORIC_MASK | SSP_ICR_RTIC_MASK);
+    LPC_SSP0->IMSC  = SSP_IMSC_RTIM_MASK;  /* back to single-byte completion */
+    hc595_finish((status == DMA_STATUS_OK) ? HC595_STATUS_OK : HC595_STATUS_ERROR);
+}
 
 void SPI_Init(void)
 {
     /* 1) Power SSP0 */
     LPC_SC->PCONP |= PCONP_PCSSP0_MASK; /* Enable power to SSP0 peripheral */
 
-    /* 2) PCLK for SSP0 = CCLK/4  (PCLKSEL1[11:10] = 00) */
-    LPC_SC->PCLKSEL1 &= ~PCLKSEL1_SSP0_PCLK_MASK; /* Clear to select CCLK/4 */
+    /* 2) PCLK for SSP0 from the clock plan (PCLKSEL1[11:10]) */
+    LPC_SC->PCLKSEL1 &= ~PCLKSEL1_SSP0_PCLK_MASK;
+    LPC_SC->PCLKSEL1 |=  PCLKSEL1_SSP0_PCLK_PLAN;
 
     /* 3) Pin select and GPIO direction
        - P0.15 -> SCK0  (function 2)
        - P0.18 -> MOSI0 (function 2)
-       - P0.16 -> GPIO  (ST_CP latch, manual pulse) */
+       - P0.16 -> GPIO  (ST_CP latch, manual pulse)
+       - P2.1  -> GPIO high (/OE, blanked until PWM_Init) */
     LPC_PINCON->PINSEL0 &= ~PINSEL0_P0_15_MASK;
     LPC_PINCON->PINSEL0 |=  PINSEL0_P0_15_FUNC_SCK0;
 
@@ -30,6 +134,12 @@ void SPI_Init(void)
     LPC_GPIO0->FIODIR   |=  GPIO0_P0_16_MASK;    /* output */
     LPC_GPIO0->FIOCLR    =  GPIO0_P0_16_MASK;    /* start LOW */
 
+    /* /OE high: keep power-up garbage in the 595 dark until PWM1.2 takes
+       over the pin with the chosen brightness */
+    LPC_GPIO2->FIOSET    =  GPIO2_P2_01_OE_MASK;
+    LPC_GPIO2->FIODIR   |=  GPIO2_P2_01_OE_MASK;
+    LPC_PINCON->PINSEL4 &= ~PINSEL4_P2_01_OE_MASK;
+
     /* Optional: no pull-up/pull-down on SCK/MOSI for cleaner lines */
     LPC_PINCON->PINMODE0 &= ~PINMODE0_P0_15_MASK; 
     LPC_PINCON->PINMODE0 |=  PINMODE0_P0_15_NO_PULL; /* P0.15 */
@@ -37,8 +147,8 @@ void SPI_Init(void)
     LPC_PINCON->PINMODE1 |=  PINMODE1_P0_18_NO_PULL; /* P0.18 */
 
     /* 4) SSP0 config: disable, set clock & mode, enable
-       SCK = PCLK / (CPSR * (SCR + 1))
-       With PCLK=25 MHz, CPSR=12, SCR=216 -> SCK ≈ 25e6/(12*217) ≈ 9600.6 Hz
+       SCK = PCLK / (CPSR * (SCR + 1)), CPSR/SCR derived in clock_plan.h
+       With PCLK=25 MHz, CPSR=2, SCR=9 -> SCK = 25e6/(2*10) = 1.25 MHz
     */
     LPC_SSP0->CR1  = 0UL;                        /* Ensure SSE=0 (disabled) */
     LPC_SSP0->CPSR = SSP_CPSR_DIVISOR;           /* CPSDVSR even, >= 2 */
@@ -46,8 +156,19 @@ void SPI_Init(void)
                     | SSP_CR0_FRF_SPI            /* SPI frame */
                     | SSP_CR0_CPOL_0             /* CPOL=0 */
                     | SSP_CR0_CPHA_0             /* CPHA=0 */
-                    | SSP_CR0_SCR_216;           /* Serial clock rate */
+                    | SSP_CR0_SCR;               /* Serial clock rate */
     LPC_SSP0->CR1  = SSP_CR1_SSE_ENABLE_MASK;    /* SSE=1 (enable, master by default) */
+
+    /* 5) Completion interrupt: the echoed byte sitting in the RX FIFO raises
+          the receive-timeout interrupt once the shift has finished */
+    LPC_SSP0->ICR  = (SSP_ICR_RORIC_MASK | SSP_ICR_RTIC_MASK);
+    LPC_SSP0->IMSC = SSP_IMSC_RTIM_MASK;
+    NVIC_EnableIRQ(SSP0_IRQn);
+
+    /* 6) GPDMA for daisy-chain frames; RX channel completion latches */
+    DMA_Init();
+    DMA_Set_Callback(DMA_CH_HC595_RX, hc595_frame_done);
+    DMA_Set_Callback(DMA_CH_HC595_TX, hc595_frame_done);  /* errors only */
 }
 
 /*
@@ -68,10 +189,125 @@ uint8_t SPI_Tx_Rx_Byte(uint8_t data)
     return (uint8_t)(LPC_SSP0->DR & SSP_DATA_8BIT_MASK);
 }
 
-/* Helper to clock one byte into 74HC595 and latch outputs */
+/*
+ * Clock one byte into 74HC595 without waiting for the shift.
+ * If a load is already in flight the value is parked and sent as soon as
+ * the current one latches; only the most recent parked value is kept.
+ */
 void HC595_Load(uint8_t value)
 {
-    (void)SPI_Tx_Rx_Byte(value);
-    LPC_GPIO0->FIOSET = GPIO0_P0_16_MASK;  /* ST_CP HIGH */
-    LPC_GPIO0->FIOCLR = GPIO0_P0_16_MASK;  /* ST_CP LOW  */
+    hc595_lock();
+    if (hc595_busy == 0U)
+    {
+        hc595_start(value, NULL);
+    }
+    else
+    {
+        hc595_pending       = value;
+        hc595_pending_valid = 1U;
+    }
+    hc595_unlock();
+}
+
+/*
+ * Start a load and return immediately. done_cb (may be NULL) runs in ISR
+ * context after the latch pulse. Returns HC595_STATUS_BUSY, without
+ * queuing anything, if another load is still in flight.
+ */
+hc595_status_t HC595_Load_Async(uint8_t value, hc595_done_cb_t done_cb)
+{
+    hc595_status_t status = HC595_STATUS_BUSY;
+
+    hc595_lock();
+    if (hc595_busy == 0U)
+    {
+        hc595_start(value, done_cb);
+        status = HC595_STATUS_OK;
+    }
+    hc595_unlock();
+
+    return status;
+}
+
+/*
+ * Stream a whole daisy chain from RAM to SSP0 with two GPDMA channels:
+ * TX feeds the FIFO from buf, RX drains the echo into a dummy byte. The RX
+ * terminal count fires only after the last byte has been shifted, which is
+ * where the single latch pulse is issued. No CPU work per byte.
+ */
+hc595_status_t HC595_LoadFrame(const uint8_t *buf, size_t n, hc595_done_cb_t done_cb)
+{
+    LPC_GPDMACH_TypeDef *rx = DMA_CHANNEL(DMA_CH_HC595_RX);
+    LPC_GPDMACH_TypeDef *tx = DMA_CHANNEL(DMA_CH_HC595_TX);
+    hc595_status_t status = HC595_STATUS_BUSY;
+
+    if ((buf == NULL) || (n == 0U) || (n > DMA_MAX_TRANSFER))
+    {
+        return HC595_STATUS_INVALID_PARAM;
+    }
+
+    hc595_lock();
+    if (hc595_busy == 0U)
+    {
+        hc595_done_cb = done_cb;
+        hc595_busy    = 1U;
+        hc595_frame   = 1U;
+
+        /* Frame completion comes from GPDMA, not the receive timeout */
+        LPC_SSP0->IMSC = 0UL;
+
+        LPC_GPDMA->IntTCClear = (1UL << DMA_CH_HC595_RX) | (1UL << DMA_CH_HC595_TX);
+        LPC_GPDMA->IntErrClr  = (1UL << DMA_CH_HC595_RX) | (1UL << DMA_CH_HC595_TX);
+
+        rx->CSrcAddr  = (uint32_t)&LPC_SSP0->DR;
+        rx->CDestAddr = (uint32_t)&hc595_rx_sink;
+        rx->CLLI      = 0UL;
+        rx->CControl  = ((uint32_t)n & DMA_CTRL_SIZE_MASK)
+                      | DMA_CTRL_SBSIZE_1 | DMA_CTRL_DBSIZE_1
+                      | DMA_CTRL_SWIDTH_8BIT | DMA_CTRL_DWIDTH_8BIT
+                      | DMA_CTRL_I_MASK;
+        rx->CConfig   = DMA_CCFG_SRCPERIPH(DMA_PERIPH_SSP0_RX)
+                      | DMA_CCFG_TT_P2M
+                      | DMA_CCFG_IE_MASK | DMA_CCFG_ITC_MASK;
+
+        tx->CSrcAddr  = (uint32_t)buf;
+        tx->CDestAddr = (uint32_t)&LPC_SSP0->DR;
+        tx->CLLI      = 0UL;
+        tx->CControl  = ((uint32_t)n & DMA_CTRL_SIZE_MASK)
+                      | DMA_CTRL_SBSIZE_1 | DMA_CTRL_DBSIZE_1
+                      | DMA_CTRL_SWIDTH_8BIT | DMA_CTRL_DWIDTH_8BIT
+                      | DMA_CTRL_SI_MASK;
+        tx->CConfig   = DMA_CCFG_DESTPERIPH(DMA_PERIPH_SSP0_TX)
+                      | DMA_CCFG_TT_M2P
+                      | DMA_CCFG_IE_MASK;
+
+        LPC_SSP0->DMACR = (SSP_DMACR_RXDMAE_MASK | SSP_DMACR_TXDMAE_MASK);
+        rx->CConfig |= DMA_CCFG_E_MASK;
+        tx->CConfig |= DMA_CCFG_E_MASK;
+
+        status = HC595_STATUS_OK;
+    }
+    hc595_unlock();
+
+    return status;
+}
+
+uint8_t HC595_Is_Busy(void)
+{
+    return hc595_busy;
+}
+
+void SSP0_IRQHandler(void)
+{
+    /* Drain the echoed byte(s); this also removes the timeout condition */
+    while ((LPC_SSP0->SR & SSP_SR_RNE_MASK) != 0UL)
+    {
+        (void)LPC_SSP0->DR;
+    }
+    LPC_SSP0->ICR = (SSP_ICR_RORIC_MASK | SSP_ICR_RTIC_MASK);
+
+    if (hc595_busy != 0U)
+    {
+        hc595_finish(HC595_STATUS_OK);
+    }
 }
@@ -7,18 +7,23 @@
 #define INDICATOR_H
 
 #include <stdint.h>
+#include <stddef.h>
+#include "clock_plan.h"
 
 /*
  * Peripheral power and clocks
  */
 #define PCONP_PCSSP0_MASK                 (1UL << 21)  /* Power to SSP0 */
 #define PCLKSEL1_SSP0_PCLK_MASK           (3UL << 10)  /* PCLKSEL1[11:10] */
+#define PCLKSEL1_SSP0_PCLK_PLAN           (CLOCK_PLAN_PCLKSEL_BITS << 10)
 
 /*
  * Pin function select (PINSEL)
  *  - P0.15 -> SCK0 (function 2)
  *  - P0.18 -> MOSI0 (function 2)
  *  - P0.16 -> GPIO (manual latch pulse)
+ *  - P2.1  -> GPIO high (/OE, outputs blanked) until PWM_Init hands it to
+ *             PWM1.2 for dimming
  */
 #define PINSEL0_P0_15_MASK                (3UL << 30)
 #define PINSEL0_P0_15_FUNC_SCK0           (2UL << 30)
@@ -28,6 +33,8 @@
 
 #define PINSEL1_P0_16_MASK                (3UL << 0)   /* 00 = GPIO */
 
+#define PINSEL4_P2_01_OE_MASK             (3UL << 2)   /* 00 = GPIO */
+
 /*
  * Pin mode (PINMODE): no pull-up/pull-down on SCK/MOSI
  */
@@ -42,27 +49,67 @@
  */
 #define GPIO0_P0_16_MASK                  (1UL << 16)
 
+/*
+ * GPIO (P2.1 is the 74HC595 /OE line, active low)
+ */
+#define GPIO2_P2_01_OE_MASK               (1UL << 1)
+
 /*
  * SSP0 register fields
  */
 #define SSP_CR1_SSE_ENABLE_MASK           (1UL << 1)   /* Enable SSP */
+#define SSP_SR_RNE_MASK                   (1UL << 2)   /* Receive FIFO not empty */
 #define SSP_SR_BSY_MASK                   (1UL << 4)   /* Busy flag */
 
-#define SSP_CPSR_DIVISOR                  (12UL)       /* Even, >= 2 */
+/* SSP0 interrupt mask / clear registers */
+#define SSP_IMSC_RTIM_MASK                (1UL << 1)   /* Receive timeout interrupt */
+#define SSP_ICR_RORIC_MASK                (1UL << 0)   /* Clear receive overrun */
+#define SSP_ICR_RTIC_MASK                 (1UL << 1)   /* Clear receive timeout */
+
+/* SSP0 DMA control register */
+#define SSP_DMACR_RXDMAE_MASK             (1UL << 0)   /* Receive DMA enable */
+#define SSP_DMACR_TXDMAE_MASK             (1UL << 1)   /* Transmit DMA enable */
 
-/* CR0 configuration: 8-bit, SPI frame, CPOL=0, CPHA=0, SCR=216 */
+#define SSP_CPSR_DIVISOR                  (CLOCK_PLAN_SSP0_CPSR)  /* Even, >= 2 */
+
+/* CR0 configuration: 8-bit, SPI frame, CPOL=0, CPHA=0, SCR from clock plan */
 #define SSP_CR0_DSS_8BIT                  (7UL << 0)
 #define SSP_CR0_FRF_SPI                   (0UL << 4)
 #define SSP_CR0_CPOL_0                    (0UL << 6)
 #define SSP_CR0_CPHA_0                    (0UL << 7)
-#define SSP_CR0_SCR_216                   (216UL << 8)
+#define SSP_CR0_SCR                       (CLOCK_PLAN_SSP0_SCR << 8)
 
 /* 8-bit data mask for readback */
 #define SSP_DATA_8BIT_MASK                (0xFFUL)
 
+/* Status codes for the asynchronous 74HC595 loader */
+typedef enum
+{
+    HC595_STATUS_OK = 0,
+    HC595_STATUS_BUSY = 1,
+    HC595_STATUS_INVALID_PARAM = 2,
+    HC595_STATUS_ERROR = 3            /* frame aborted by a GPDMA error, not latched */
+} hc595_status_t;
+
+/* Completion callback, invoked from SSP0/GPDMA ISR context right after the
+   latch pulse (OK), or once an aborted frame has been released (ERROR) */
+typedef void (*hc595_done_cb_t)(hc595_status_t status);
+
 /* Public API */
 void SPI_Init(void);
+/* Blocking transfer; do not mix with an asynchronous load in flight */
 uint8_t SPI_Tx_Rx_Byte(uint8_t data);
+/* Non-blocking: starts the shift, or queues the value (latest wins) if busy */
 void HC595_Load(uint8_t value);
+/* Non-blocking: starts the shift and returns, or reports BUSY without queuing */
+hc595_status_t HC595_Load_Async(uint8_t value, hc595_done_cb_t done_cb);
+/* Non-blocking: streams n bytes of a daisy chain by GPDMA and latches once.
+   buf[0] ends up in the register furthest from the MCU; buf must stay
+   valid until done_cb runs / HC595_Is_Busy() returns 0 */
+hc595_status_t HC595_LoadFrame(const uint8_t *buf, size_t n, hc595_done_cb_t done_cb);
+/* Returns 1 while a shift/latch is still in flight */
+uint8_t HC595_Is_Busy(void);
+
+void SSP0_IRQHandler(void);
 
 #endif /* INDICATOR_H */
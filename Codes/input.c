@@ -0,0 +1,226 @@
+/*
+ * File: input.c
+ * Purpose: GPIO edge interrupts, integrating debounce and input events.
+ * Notes: The edge ISR only stamps and flags; the 1 ms sampler runs in
+ *        TIMER0 ISR context, so it is the same producer as the timer ticks
+ *        and timer_evq stays single-producer. The sampler stops itself
+ *        once every pin has settled.
+ *        A pin settles when its integrator is back at the rail of its
+ *        stable level and no edge arrived since the last sample; the next
+ *        edge after that is stamped as the start of a new transition.
+ *        The stable level only changes once its event is queued: with
+ *        timer_evq full the pin stays unsettled and the next sample posts
+ *        it again, with the original edge time.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "critical.h"
+#include "evq.h"
+#include "systime.h"
+#include "swtimer.h"
+#include "timer.h"
+#include "sched.h"
+#include "input.h"
+
+typedef struct
+{
+    uint8_t  port;      /* 0 or 2: ports with edge interrupts */
+    uint32_t mask;
+} input_pin_t;
+
+typedef struct
+{
+    uint64_t edge_us;   /* first edge of the transition in progress */
+    uint8_t  integ;     /* 0..INPUT_INTEG_MAX, pressed counts up */
+    uint8_t  stable;
+    uint8_t  busy;      /* being sampled */
+    uint8_t  armed;     /* next edge starts a transition */
+    uint8_t  dirty;     /* edge seen since the last sample */
+} input_state_t;
+
+static const input_pin_t input_pins[INPUT_COUNT] =
+{
+    { 2U, INPUT_GPIO2_P2_02_LEFT_MASK },
+    { 2U, INPUT_GPIO2_P2_03_RIGHT_MASK },
+    { 2U, INPUT_GPIO2_P2_04_HAZARD_MASK },
+    { 2U, INPUT_GPIO2_P2_05_SEATBELT_MASK },
+    { 2U, INPUT_GPIO2_P2_06_NIGHT_MASK }
+};
+
+static input_state_t     input_state[INPUT_COUNT];
+static swtimer_t         input_sampler;
+static volatile uint32_t input_edges = 0U;
+
+/* Active low: a closed switch pulls the pin to ground */
+static uint8_t input_raw(const input_pin_t *pin)
+{
+    uint32_t levels = (pin->port == 0U) ? LPC_GPIO0->FIOPIN : LPC_GPIO2->FIOPIN;
+    return ((levels & pin->mask) == 0U) ? 1U : 0U;
+}
+
+/* TIMER0 ISR context */
+static void input_sample(void *ctx)
+{
+    uint8_t busy = 0U;
+    uint8_t i;
+
+    (void)ctx;
+    for (i = 0U; i < (uint8_t)INPUT_COUNT; i++)
+    {
+        input_state_t *s = &input_state[i];
+        uint32_t       primask;
+
+        if (s->busy == 0U)
+        {
+            continue;
+        }
+
+        if (input_raw(&input_pins[i]) != 0U)
+        {
+            if (s->integ < INPUT_INTEG_MAX)
+            {
+                s->integ++;
+            }
+        }
+        else
+        {
+            if (s->integ > 0U)
+            {
+                s->integ--;
+            }
+        }
+
+        primask = Critical_Enter();
+        if ((s->stable == 0U) && (s->integ == INPUT_INTEG_MAX))
+        {
+            if (EvQ_Post_At(&timer_evq, (uint8_t)EVT_INPUT, INPUT_EVT_ARG(i, 1U), s->edge_us) == EVQ_STATUS_OK)
+            {
+                s->stable = 1U;
+                s->armed  = 1U;
+                Sched_Kick();
+            }
+        }
+        else if ((s->stable != 0U) && (s->integ == 0U))
+        {
+            if (EvQ_Post_At(&timer_evq, (uint8_t)EVT_INPUT, INPUT_EVT_ARG(i, 0U), s->edge_us) == EVQ_STATUS_OK)
+            {
+                s->stable = 0U;
+                s->armed  = 1U;
+                Sched_Kick();
+            }
+        }
+        else
+        {
+            /* Still integrating */
+        }
+
+        if ((s->dirty == 0U) && (s->integ == ((s->stable != 0U) ? INPUT_INTEG_MAX : 0U)))
+        {
+            s->busy  = 0U;
+            s->armed = 1U;
+        }
+        else
+        {
+            busy = 1U;
+        }
+        s->dirty = 0U;
+        Critical_Exit(primask);
+    }
+
+    if (busy == 0U)
+    {
+        /* All settled: stop, unless an edge came in since its pin was done */
+        uint32_t primask = Critical_Enter();
+
+        for (i = 0U; i < (uint8_t)INPUT_COUNT; i++)
+        {
+            busy |= input_state[i].busy;
+        }
+        if (busy == 0U)
+        {
+            SwTimer_Stop(&input_sampler);
+        }
+        Critical_Exit(primask);
+    }
+}
+
+void Input_Init(void)
+{
+    uint32_t all = 0U;
+    uint8_t  i;
+
+    /* P2.2..P2.6 as GPIO inputs with pull-ups (PINSEL4/PINMODE4 = 00) */
+    LPC_PINCON->PINSEL4  &= ~INPUT_PINSEL4_P2_02_06_MASK;
+    LPC_PINCON->PINMODE4 &= ~INPUT_PINMODE4_P2_02_06_MASK;
+
+    for (i = 0U; i < (uint8_t)INPUT_COUNT; i++)
+    {
+        input_state_t *s = &input_state[i];
+
+        LPC_GPIO2->FIODIR &= ~input_pins[i].mask;
+        s->stable  = input_raw(&input_pins[i]);
+        s->integ   = (s->stable != 0U) ? INPUT_INTEG_MAX : 0U;
+        s->busy    = 0U;
+        s->armed   = 1U;
+        s->dirty   = 0U;
+        s->edge_us = 0U;
+        all |= input_pins[i].mask;
+    }
+
+    /* Both edges on every switch pin; stale flags cleared first */
+    LPC_GPIOINT->IO2IntClr = all;
+    LPC_GPIOINT->IO2IntEnR |= all;
+    LPC_GPIOINT->IO2IntEnF |= all;
+    NVIC_EnableIRQ(EINT3_IRQn);
+}
+
+uint8_t Input_Level(input_id_t id)
+{
+    return ((uint32_t)id < (uint32_t)INPUT_COUNT) ? input_state[id].stable : 0U;
+}
+
+uint32_t Input_Edge_Count(void)
+{
+    return input_edges;
+}
+
+void EINT3_IRQHandler(void)
+{
+    uint64_t now   = time_now_us();
+    uint32_t flag0 = LPC_GPIOINT->IO0IntStatR | LPC_GPIOINT->IO0IntStatF;
+    uint32_t flag2 = LPC_GPIOINT->IO2IntStatR | LPC_GPIOINT->IO2IntStatF;
+    uint8_t  start = 0U;
+    uint32_t primask;
+    uint8_t  i;
+
+    LPC_GPIOINT->IO0IntClr = flag0;
+    LPC_GPIOINT->IO2IntClr = flag2;
+
+    primask = Critical_Enter();
+    for (i = 0U; i < (uint8_t)INPUT_COUNT; i++)
+    {
+        uint32_t flags = (input_pins[i].port == 0U) ? flag0 : flag2;
+
+        if ((flags & input_pins[i].mask) != 0U)
+        {
+            input_state_t *s = &input_state[i];
+
+            input_edges++;
+            if (s->armed != 0U)
+            {
+                s->armed   = 0U;
+                s->edge_us = now;
+            }
+            s->dirty = 1U;
+            s->busy  = 1U;
+            start    = 1U;
+        }
+    }
+    if ((start != 0U) && (SwTimer_Is_Active(&input_sampler) == 0U))
+    {
+        (void)SwTimer_Start(&input_sampler, INPUT_SAMPLE_MS, INPUT_SAMPLE_MS, input_sample, NULL);
+    }
+    Critical_Exit(primask);
+}
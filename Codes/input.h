@@ -0,0 +1,59 @@
+/*
+ * File: input.h
+ * Purpose: Interrupt-driven, timestamped switch inputs (MISRA C:2012 aligned)
+ *
+ * Switches are active-low GPIO inputs with pull-ups. The GPIO rising and
+ * falling edge interrupts (EINT3 vector, ports 0 and 2) timestamp the first
+ * edge of every transition with time_now_us(). Only while a pin is
+ * unsettled, a 1 ms swtimer samples it into a per-pin integrator; a new
+ * stable level is published as EVT_INPUT in timer_evq carrying the edge
+ * time, and the scheduler is kicked. Nothing polls the switches otherwise.
+ */
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+
+/* Switch pins (active low, internal pull-up) */
+#define INPUT_GPIO2_P2_02_LEFT_MASK       (1UL << 2)
+#define INPUT_GPIO2_P2_03_RIGHT_MASK      (1UL << 3)
+#define INPUT_GPIO2_P2_04_HAZARD_MASK     (1UL << 4)
+#define INPUT_GPIO2_P2_05_SEATBELT_MASK   (1UL << 5)
+#define INPUT_GPIO2_P2_06_NIGHT_MASK      (1UL << 6)
+
+/* PINSEL4 / PINMODE4 fields of P2.2..P2.6 (00 = GPIO, 00 = pull-up) */
+#define INPUT_PINSEL4_P2_02_06_MASK       (0x3FFUL << 4)
+#define INPUT_PINMODE4_P2_02_06_MASK      (0x3FFUL << 4)
+
+/* Debounce: one sample per INPUT_SAMPLE_MS counts the integrator up
+   (closed) or down (open); the level changes when it hits a rail, i.e.
+   INPUT_INTEG_MAX samples net, 4 ms for a clean edge */
+#define INPUT_SAMPLE_MS                   (1U)
+#define INPUT_INTEG_MAX                   (4U)
+
+typedef enum
+{
+    INPUT_LEFT = 0,
+    INPUT_RIGHT = 1,
+    INPUT_HAZARD = 2,
+    INPUT_SEATBELT = 3,
+    INPUT_NIGHT = 4,
+    INPUT_COUNT = 5
+} input_id_t;
+
+/* EVT_INPUT argument: input id and new level (1 = switch on) */
+#define INPUT_EVT_ARG(id, level)          ((uint8_t)(((uint32_t)(id) << 1) | ((uint32_t)(level) & 1UL)))
+#define INPUT_EVT_ID(arg)                 ((uint8_t)((arg) >> 1))
+#define INPUT_EVT_LEVEL(arg)              ((uint8_t)((arg) & 1U))
+
+/* Public API */
+/* Configure pins and edge interrupts; call after Timer_Init() */
+void     Input_Init(void);
+/* Last debounced level, 1 = switch on */
+uint8_t  Input_Level(input_id_t id);
+/* Raw edge interrupts taken, bounces included */
+uint32_t Input_Edge_Count(void);
+void     EINT3_IRQHandler(void);
+
+#endif /* INPUT_H */
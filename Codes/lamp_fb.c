@@ -0,0 +1,206 @@
+/*
+ * File: lamp_fb.c
+ * Purpose: Lamp output framebuffer: bit-mask updates, one coalesced flush.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include "lamp_fb.h"
+#include "indicator.h"
+#include "systime.h"
+#include "sched.h"
+
+/* GPIO location of a discrete lamp */
+typedef struct
+{
+    LPC_GPIO_TypeDef *port;
+    uint32_t          pin_mask;
+} lampfb_discrete_t;
+
+static const lampfb_discrete_t lampfb_discrete_map[LAMPFB_DISCRETE_COUNT] =
+{
+    { LPC_GPIO1, LAMPFB_GPIO1_P1_29_MASK }   /* Seatbelt */
+};
+
+/* Image the lamp owners write */
+static uint8_t lampfb_shadow[LAMPFB_HC595_BYTES];
+static uint8_t lampfb_discrete;
+
+/* Chain image in flight / last latched, in shift order (furthest first) */
+static uint8_t lampfb_tx[LAMPFB_HC595_BYTES];
+static uint8_t lampfb_discrete_out;
+static volatile uint8_t lampfb_valid = 0U;  /* 0 until a chain frame has been accepted by the loader */
+
+/* Chain frames are numbered from 1 as the loader accepts them. The HC595
+   done callback records the number and time of the frame that latched;
+   one frame is in flight at a time, so both are stable until the next
+   LampFB_Flush() sends another */
+static uint32_t          lampfb_seq = 0U;
+static volatile uint32_t lampfb_flight_seq = 0U;
+static volatile uint32_t lampfb_latch_seq = 0U;
+static volatile uint64_t lampfb_latch_us;
+
+/* SSP0/GPDMA ISR context, right after the latch pulse or an aborted frame */
+static void lampfb_latch_done(hc595_status_t status)
+{
+    if (status == HC595_STATUS_OK)
+    {
+        lampfb_latch_us  = time_now_us();
+        lampfb_latch_seq = lampfb_flight_seq;
+    }
+    else
+    {
+        lampfb_valid = 0U;   /* not latched: send the whole frame again */
+    }
+    Sched_Kick();   /* report it, and send a frame deferred while busy */
+}
+
+void LampFB_Init(void)
+{
+    uint8_t i;
+
+    for (i = 0U; i < LAMPFB_HC595_BYTES; i++)
+    {
+        lampfb_shadow[i] = 0U;
+    }
+    lampfb_discrete     = 0U;
+    lampfb_discrete_out = 0U;
+    lampfb_valid        = 0U;
+    lampfb_seq          = 0U;
+    lampfb_flight_seq   = 0U;
+    lampfb_latch_seq    = 0U;
+
+    /* Discrete lamps start OFF; the chain is forced out on the first flush */
+    for (i = 0U; i < LAMPFB_DISCRETE_COUNT; i++)
+    {
+        lampfb_discrete_map[i].port->FIODIR |= lampfb_discrete_map[i].pin_mask;
+        lampfb_discrete_map[i].port->FIOCLR  = lampfb_discrete_map[i].pin_mask;
+    }
+}
+
+void LampFB_Write(uint8_t index, uint8_t mask, uint8_t bits)
+{
+    if (index < LAMPFB_HC595_BYTES)
+    {
+        lampfb_shadow[index] = (uint8_t)((lampfb_shadow[index] & (uint8_t)~mask) | (bits & mask));
+    }
+}
+
+void LampFB_Write_Discrete(uint8_t mask, uint8_t bits)
+{
+    lampfb_discrete = (uint8_t)((lampfb_discrete & (uint8_t)~mask) | (bits & mask));
+}
+
+uint8_t LampFB_Read(uint8_t index)
+{
+    return (index < LAMPFB_HC595_BYTES) ? lampfb_shadow[index] : 0U;
+}
+
+void LampFB_Flush(void)
+{
+    uint8_t changed = 0U;
+    uint8_t i;
+
+    /* Discrete lamps: drive only the pins that changed */
+    {
+        uint8_t diff = (uint8_t)(lampfb_discrete ^ lampfb_discrete_out);
+        for (i = 0U; i < LAMPFB_DISCRETE_COUNT; i++)
+        {
+            uint8_t bit = (uint8_t)(1U << i);
+            if ((diff & bit) != 0U)
+            {
+                if ((lampfb_discrete & bit) != 0U)
+                {
+                    lampfb_discrete_map[i].port->FIOSET = lampfb_discrete_map[i].pin_mask;
+                }
+                else
+                {
+                    lampfb_discrete_map[i].port->FIOCLR = lampfb_discrete_map[i].pin_mask;
+                }
+            }
+        }
+        lampfb_discrete_out = lampfb_discrete;
+    }
+
+    /* Chain still shifting the previous frame: its latch kicks a retry */
+    if (HC595_Is_Busy() != 0U)
+    {
+        return;
+    }
+
+    for (i = 0U; i < LAMPFB_HC595_BYTES; i++)
+    {
+        uint8_t slot = (uint8_t)(LAMPFB_HC595_BYTES - 1U - i);
+        if ((lampfb_valid == 0U) || (lampfb_tx[slot] != lampfb_shadow[i]))
+        {
+            lampfb_tx[slot] = lampfb_shadow[i];
+            changed = 1U;
+        }
+    }
+
+    if (changed != 0U)
+    {
+        hc595_status_t status;
+
+        lampfb_flight_seq = lampfb_seq + 1U;
+        if (LAMPFB_HC595_BYTES == 1U)
+        {
+            status = HC595_Load_Async(lampfb_tx[0], lampfb_latch_done);
+        }
+        else
+        {
+            status = HC595_LoadFrame(lampfb_tx, LAMPFB_HC595_BYTES, lampfb_latch_done);
+        }
+        /* Not sent: the whole frame stays pending for the next pass */
+        if (status == HC595_STATUS_OK)
+        {
+            lampfb_seq   = lampfb_flight_seq;
+            lampfb_valid = 1U;
+        }
+        else
+        {
+            lampfb_valid = 0U;
+        }
+    }
+}
+
+uint8_t LampFB_Read_Out(uint8_t index)
+{
+    return (index < LAMPFB_HC595_BYTES) ? lampfb_tx[LAMPFB_HC595_BYTES - 1U - index] : 0U;
+}
+
+uint32_t LampFB_Sent_Seq(void)
+{
+    return lampfb_seq;
+}
+
+uint8_t LampFB_Latched(uint32_t seq, uint64_t *at_us)
+{
+    if ((seq == 0U) || ((int32_t)(lampfb_latch_seq - seq) < 0))
+    {
+        return 0U;
+    }
+    if (at_us != NULL)
+    {
+        *at_us = lampfb_latch_us;
+    }
+    return 1U;
+}
+
+uint8_t LampFB_Pending(void)
+{
+    uint8_t i;
+
+    if ((lampfb_valid == 0U) || (HC595_Is_Busy() != 0U))
+    {
+        return 1U;
+    }
+    for (i = 0U; i < LAMPFB_HC595_BYTES; i++)
+    {
+        if (lampfb_tx[LAMPFB_HC595_BYTES - 1U - i] != lampfb_shadow[i])
+        {
+            return 1U;
+        }
+    }
+    return 0U;
+}
@@ -0,0 +1,55 @@
+/*
+ * File: lamp_fb.h
+ * Purpose: Shadow image of all lamp outputs with dirty tracking (MISRA C:2012 aligned)
+ *
+ * Lamp owners only update bits in the shadow image; LampFB_Flush() is the
+ * single point where outputs change. It pushes the 74HC595 chain only when
+ * its image differs from what was last latched, and touches only the
+ * discrete GPIO lamps whose state changed.
+ */
+
+#ifndef LAMP_FB_H
+#define LAMP_FB_H
+
+#include <stdint.h>
+
+/* Number of 74HC595 registers in the chain; byte 0 is nearest the MCU */
+#define LAMPFB_HC595_BYTES                (2U)
+
+/* Chain byte assignment */
+#define LAMPFB_BYTE_TURN                  (0U)   /* Turn / hazard indicator LEDs */
+#define LAMPFB_BYTE_WARN                  (1U)   /* Warning lamps */
+
+/* Warning byte bits */
+#define LAMPFB_WARN_SERVICE_MASK          (1U << 0)
+#define LAMPFB_WARN_LOW_FUEL_MASK         (1U << 1)
+
+/* Discrete (direct GPIO) lamps: bit positions in the discrete image */
+#define LAMPFB_DISCRETE_SEATBELT_MASK     (1U << 0)   /* P1.29 */
+#define LAMPFB_DISCRETE_COUNT             (1U)
+
+/* GPIO pin of each discrete lamp */
+#define LAMPFB_GPIO1_P1_29_MASK           (1UL << 29)
+
+/* Public API (main context only) */
+void    LampFB_Init(void);
+/* Update the bits selected by mask in chain byte 'index' */
+void    LampFB_Write(uint8_t index, uint8_t mask, uint8_t bits);
+/* Update the bits selected by mask in the discrete lamp image */
+void    LampFB_Write_Discrete(uint8_t mask, uint8_t bits);
+uint8_t LampFB_Read(uint8_t index);
+/* Push changed outputs; call once per scheduler tick. The chain latches
+   asynchronously, or on a later tick while the previous frame is busy */
+void    LampFB_Flush(void);
+/* Chain byte 'index' as last sent to the chain */
+uint8_t  LampFB_Read_Out(uint8_t index);
+/* Number of the newest chain frame the loader accepted (from 1; 0 = none) */
+uint32_t LampFB_Sent_Seq(void);
+/* 1 once frame 'seq' has latched, with the latch time of the newest latched
+   frame (time_now_us(), taken in the HC595 done callback) in *at_us. That
+   is frame 'seq' itself until the next LampFB_Flush() sends another */
+uint8_t  LampFB_Latched(uint32_t seq, uint64_t *at_us);
+/* 1 while the chain outputs differ from the shadow image or are shifting */
+uint8_t  LampFB_Pending(void);
+
+#endif /* LAMP_FB_H */
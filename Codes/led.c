@@ -1,15 +1,17 @@
 #include "LPC17xx.h"
 #include <stdint.h>
+#include "lamp_fb.h"
 
 void LED_Init(void)
 {
     LPC_GPIO1->FIODIR = (1 << 29);
 }
 
+/* Seatbelt lamp on P1.29; the pin itself changes on the next LampFB_Flush() */
 void LED_Status(uint8_t status)
 {
     if (status == 4)
-        LPC_GPIO1->FIOSET = (0x1 << 29);
+        LampFB_Write_Discrete(LAMPFB_DISCRETE_SEATBELT_MASK, LAMPFB_DISCRETE_SEATBELT_MASK);
     else if (status == 0)
-        LPC_GPIO1->FIOCLR = (0x1 << 29);
+        LampFB_Write_Discrete(LAMPFB_DISCRETE_SEATBELT_MASK, 0U);
 }
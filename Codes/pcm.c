@@ -0,0 +1,250 @@
+/*
+ * File: pcm.c
+ * Purpose: DAC + GPDMA ping-pong streaming with on-the-fly sample decode.
+ * Notes: Two linked-list items point at each other, so the DMA never stops
+ *        between half-buffers. On each terminal count the half that just
+ *        drained is refilled while the other one plays. When the clip ends
+ *        the rest of the half is padded with midscale, and the channel is
+ *        stopped once that last half has drained.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "dma.h"
+#include "pcm.h"
+
+/* IMA ADPCM tables */
+static const int16_t pcm_ima_step[89] =
+{
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+       19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+       50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+      130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+      337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+      876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+     5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t pcm_ima_index[16] =
+{
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/* Source cursor and decoder state */
+typedef struct
+{
+    const pcm_clip_t *clip;
+    uint32_t          pos;          /* next byte */
+    uint32_t          block_end;    /* ADPCM: end of the current block */
+    int32_t           predictor;
+    uint8_t           index;
+    uint8_t           high_nibble;  /* ADPCM: next nibble is the high one */
+} pcm_src_t;
+
+static uint32_t           pcm_buf[2][PCM_BLOCK_SAMPLES];
+static dma_lli_t          pcm_lli[2];
+static pcm_src_t          pcm_src;
+static volatile uint8_t   pcm_playing = 0U;
+static uint8_t            pcm_fill;        /* half the DMA finishes next */
+static uint8_t            pcm_src_done;
+static uint8_t            pcm_last_half;   /* half holding the final samples */
+
+#define PCM_CTRL_BASE     (DMA_CTRL_SBSIZE_1 | DMA_CTRL_DBSIZE_1 | \
+                           DMA_CTRL_SWIDTH_32BIT | DMA_CTRL_DWIDTH_32BIT | \
+                           DMA_CTRL_SI_MASK | DMA_CTRL_I_MASK)
+
+static uint16_t pcm_ima_nibble(pcm_src_t *s, uint8_t nib)
+{
+    int32_t step = pcm_ima_step[s->index];
+    int32_t diff = step >> 3;
+    int32_t idx;
+
+    if ((nib & 4U) != 0U) { diff += step; }
+    if ((nib & 2U) != 0U) { diff += step >> 1; }
+    if ((nib & 1U) != 0U) { diff += step >> 2; }
+    s->predictor += ((nib & 8U) != 0U) ? -diff : diff;
+    if (s->predictor > 32767)  { s->predictor = 32767; }
+    if (s->predictor < -32768) { s->predictor = -32768; }
+
+    idx = (int32_t)s->index + pcm_ima_index[nib];
+    if (idx < 0)  { idx = 0; }
+    if (idx > 88) { idx = 88; }
+    s->index = (uint8_t)idx;
+
+    return (uint16_t)((uint32_t)(s->predictor + 32768) >> 6);
+}
+
+/* Next 10-bit sample; returns 0 when the clip is exhausted */
+static uint8_t pcm_next(pcm_src_t *s, uint16_t *out)
+{
+    const pcm_clip_t *c = s->clip;
+
+    if (c->format == (uint8_t)PCM_FMT_U8)
+    {
+        if (s->pos >= c->length)
+        {
+            return 0U;
+        }
+        *out = (uint16_t)((uint16_t)c->data[s->pos] << 2);
+        s->pos++;
+        return 1U;
+    }
+
+    /* IMA ADPCM: 4-byte header (int16 sample, step index, pad) per block */
+    if (s->pos >= s->block_end)
+    {
+        if ((s->pos + 4U) > c->length)
+        {
+            return 0U;
+        }
+        s->predictor   = (int16_t)((uint16_t)c->data[s->pos] | ((uint16_t)c->data[s->pos + 1U] << 8));
+        s->index       = (c->data[s->pos + 2U] > 88U) ? 88U : c->data[s->pos + 2U];
+        s->block_end   = s->pos + c->block_bytes;
+        if (s->block_end > c->length)
+        {
+            s->block_end = c->length;
+        }
+        s->pos        += 4U;
+        s->high_nibble = 0U;
+        *out = (uint16_t)((uint32_t)(s->predictor + 32768) >> 6);
+        return 1U;
+    }
+
+    if (s->high_nibble == 0U)
+    {
+        s->high_nibble = 1U;
+        *out = pcm_ima_nibble(s, (uint8_t)(c->data[s->pos] & 0x0FU));
+    }
+    else
+    {
+        s->high_nibble = 0U;
+        *out = pcm_ima_nibble(s, (uint8_t)(c->data[s->pos] >> 4));
+        s->pos++;
+    }
+    return 1U;
+}
+
+static void pcm_refill(uint8_t half)
+{
+    uint32_t *dst = pcm_buf[half];
+    uint32_t  i;
+
+    for (i = 0U; i < PCM_BLOCK_SAMPLES; i++)
+    {
+        uint16_t v = DAC_MIDSCALE;
+
+        if (pcm_src_done == 0U)
+        {
+            if (pcm_next(&pcm_src, &v) == 0U)
+            {
+                pcm_src_done  = 1U;
+                pcm_last_half = half;
+                v = DAC_MIDSCALE;
+            }
+        }
+        dst[i] = DAC_CR_VALUE(v);
+    }
+}
+
+static void pcm_halt(void)
+{
+    DMA_CHANNEL(DMA_CH_PCM)->CConfig = 0UL;
+    LPC_DAC->CTRL = 0UL;
+    LPC_DAC->CR   = DAC_CR_VALUE(DAC_MIDSCALE);
+    pcm_playing   = 0U;
+}
+
+static void pcm_dma_done(uint8_t channel, dma_status_t status)
+{
+    uint8_t half = pcm_fill;
+    (void)channel;
+
+    if ((status != DMA_STATUS_OK) || ((pcm_src_done != 0U) && (half == pcm_last_half)))
+    {
+        pcm_halt();
+        return;
+    }
+
+    pcm_fill = (uint8_t)(half ^ 1U);
+    pcm_refill(half);
+}
+
+void PCM_Init(void)
+{
+    /* DAC clock from the plan, P0.26 as AOUT */
+    LPC_SC->PCLKSEL0 &= ~PCLKSEL0_PCLK_DAC_MASK;
+    LPC_SC->PCLKSEL0 |=  PCLKSEL0_PCLK_DAC_PLAN;
+    LPC_PINCON->PINSEL1  = (LPC_PINCON->PINSEL1  & ~PINSEL1_P0_26_MASK)  | PINSEL1_P0_26_AOUT;
+    LPC_PINCON->PINMODE1 = (LPC_PINCON->PINMODE1 & ~PINMODE1_P0_26_MASK) | PINMODE1_P0_26_NOPULL;
+
+    DMA_Init();
+    DMA_Set_Callback(DMA_CH_PCM, pcm_dma_done);
+
+    pcm_halt();
+}
+
+pcm_status_t PCM_Play(const pcm_clip_t *clip)
+{
+    LPC_GPDMACH_TypeDef *ch = DMA_CHANNEL(DMA_CH_PCM);
+    uint8_t h;
+
+    if ((clip == NULL) || (clip->data == NULL) || (clip->length == 0U) ||
+        (clip->rate_hz < PCM_RATE_MIN_HZ) || (clip->rate_hz > PCM_RATE_MAX_HZ) ||
+        ((clip->format == (uint8_t)PCM_FMT_IMA_ADPCM) && (clip->block_bytes <= 4U)) ||
+        (clip->format > (uint8_t)PCM_FMT_IMA_ADPCM))
+    {
+        return PCM_STATUS_INVALID_PARAM;
+    }
+
+    PCM_Stop();
+
+    pcm_src.clip      = clip;
+    pcm_src.pos       = 0U;
+    pcm_src.block_end = 0U;
+    pcm_src_done      = 0U;
+    pcm_last_half     = 0U;
+
+    /* Circular list: half 0 -> half 1 -> half 0 ... */
+    for (h = 0U; h < 2U; h++)
+    {
+        pcm_lli[h].src     = (uint32_t)&pcm_buf[h][0];
+        pcm_lli[h].dst     = (uint32_t)&LPC_DAC->CR;
+        pcm_lli[h].next    = (uint32_t)&pcm_lli[h ^ 1U];
+        pcm_lli[h].control = PCM_CTRL_BASE | PCM_BLOCK_SAMPLES;
+        pcm_refill(h);
+    }
+    pcm_fill = 0U;
+
+    /* Load the channel with item 0 */
+    LPC_GPDMA->IntTCClear = (1UL << DMA_CH_PCM);
+    LPC_GPDMA->IntErrClr  = (1UL << DMA_CH_PCM);
+    ch->CSrcAddr  = pcm_lli[0].src;
+    ch->CDestAddr = pcm_lli[0].dst;
+    ch->CLLI      = pcm_lli[0].next;
+    ch->CControl  = pcm_lli[0].control;
+
+    /* DAC counter paces the requests; DBLBUF loads DACR on each timeout */
+    LPC_DAC->CNTVAL = (uint32_t)((CLOCK_PLAN_PCLK_HZ + ((uint32_t)clip->rate_hz / 2U)) / clip->rate_hz);
+    pcm_playing     = 1U;
+    ch->CConfig     = DMA_CCFG_DESTPERIPH(DMA_PERIPH_DAC) | DMA_CCFG_TT_M2P |
+                      DMA_CCFG_IE_MASK | DMA_CCFG_ITC_MASK | DMA_CCFG_E_MASK;
+    LPC_DAC->CTRL   = DAC_CTRL_DBLBUF_ENA | DAC_CTRL_CNT_ENA | DAC_CTRL_DMA_ENA;
+
+    return PCM_STATUS_OK;
+}
+
+void PCM_Stop(void)
+{
+    NVIC_DisableIRQ(DMA_IRQn);  /* no refill may race the teardown */
+    pcm_halt();
+    NVIC_EnableIRQ(DMA_IRQn);
+}
+
+uint8_t PCM_Is_Playing(void)
+{
+    return pcm_playing;
+}
@@ -0,0 +1,77 @@
+/*
+ * File: pcm.h
+ * Purpose: Sampled chime playback on the DAC through GPDMA (MISRA C:2012 aligned)
+ *
+ * A second audio backend next to the PWM1 buzzer. Flash-resident clips
+ * (8-bit unsigned PCM or 4-bit IMA ADPCM blocks) are converted into two
+ * RAM half-buffers that GPDMA streams to the DAC on P0.26 in a circular
+ * linked list, paced by the DAC's own counter. The CPU only refills a
+ * half-buffer per DMA terminal count (PCM_BLOCK_SAMPLES samples).
+ */
+
+#ifndef PCM_H
+#define PCM_H
+
+#include <stdint.h>
+#include "clock_plan.h"
+
+/* Status codes for PCM APIs */
+typedef enum
+{
+    PCM_STATUS_OK = 0,
+    PCM_STATUS_INVALID_PARAM = 1
+} pcm_status_t;
+
+/* Power/clock: DAC has no PCONP bit; PCLKSEL0 bits [23:22] */
+#define PCLKSEL0_PCLK_DAC_MASK            (3UL << 22)
+#define PCLKSEL0_PCLK_DAC_PLAN            (CLOCK_PLAN_PCLKSEL_BITS << 22)
+
+/* P0.26 as AOUT (PINSEL1 bits 21:20 = 10), no pull (PINMODE1 bits 21:20 = 10) */
+#define PINSEL1_P0_26_MASK                (3UL << 20)
+#define PINSEL1_P0_26_AOUT                (2UL << 20)
+#define PINMODE1_P0_26_MASK               (3UL << 20)
+#define PINMODE1_P0_26_NOPULL             (2UL << 20)
+
+/* DACR value field [15:6]; BIAS = 0 for the fast (1 us) settling mode */
+#define DAC_CR_VALUE(v10)                 (((uint32_t)(v10) & 0x3FFUL) << 6)
+#define DAC_MIDSCALE                      (512U)
+
+/* DACCTRL bits */
+#define DAC_CTRL_DBLBUF_ENA               (1UL << 1)
+#define DAC_CTRL_CNT_ENA                  (1UL << 2)
+#define DAC_CTRL_DMA_ENA                  (1UL << 3)
+
+/* Samples per half-buffer (one DMA linked-list item) */
+#define PCM_BLOCK_SAMPLES                 (128U)
+
+#if (PCM_BLOCK_SAMPLES > 4095U)
+#error "pcm: half-buffer exceeds one DMA transfer"
+#endif
+
+/* Sample rate limits: the DAC counter is 16 bits of PCLK */
+#define PCM_RATE_MIN_HZ                   ((CLOCK_PLAN_PCLK_HZ / 0xFFFFUL) + 1UL)
+#define PCM_RATE_MAX_HZ                   (48000UL)
+
+typedef enum
+{
+    PCM_FMT_U8 = 0,          /* unsigned 8-bit, 0x80 = silence */
+    PCM_FMT_IMA_ADPCM = 1    /* 4-bit IMA ADPCM, mono WAV block layout */
+} pcm_format_t;
+
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t       length;        /* bytes */
+    uint16_t       rate_hz;
+    uint16_t       block_bytes;   /* ADPCM block size (header + nibbles) */
+    uint8_t        format;        /* pcm_format_t */
+} pcm_clip_t;
+
+/* Public API */
+void         PCM_Init(void);
+/* Start clip, replacing whatever is playing */
+pcm_status_t PCM_Play(const pcm_clip_t *clip);
+void         PCM_Stop(void);
+uint8_t      PCM_Is_Playing(void);
+
+#endif /* PCM_H */
@@ -0,0 +1,504 @@
+/*
+ * File: persist.c
+ * Purpose: RAM write-behind cache and background EEPROM save state machine.
+ * Notes: A save moves through WRITE (one page-aligned chunk on the bus) and
+ *        POLL (address-only transfers every PERSIST_POLL_MS until the
+ *        EEPROM acknowledges again). The steps run in I2C0 and TIMER0 ISR
+ *        context; both have the same NVIC priority, so they never preempt
+ *        each other. Main context touches the cache and starts a save with
+ *        interrupts masked, and the record is serialised when the save
+ *        starts, so values set meanwhile go into the next save.
+ *
+ *        Record layout (little endian): version u16, crc u16, seq u32, then
+ *        PERSIST_FIELD_COUNT u32 values. The CRC covers everything after
+ *        itself, as in the pseudocode.
+ *
+ *        Without an EEPROM the fields are keys of the flash store instead,
+ *        saved from main context by Persist_Update() only.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "critical.h"
+#include "systime.h"
+#include "swtimer.h"
+#include "crc16.h"
+#include "i2c.h"
+#include "flash_kv.h"
+#include "persist.h"
+
+#define PERSIST_OFS_CRC       (2U)
+#define PERSIST_OFS_SEQ       (4U)
+#define PERSIST_OFS_VALUES    (8U)
+#define PERSIST_LOAD_US       (10000U)    /* boot read timeout per slot */
+#define PERSIST_MINUTE_US     (60000000ULL)
+#define PERSIST_BOD_REARM_US  (1000000ULL)
+
+typedef enum
+{
+    PERSIST_IDLE = 0,
+    PERSIST_WRITE = 1,
+    PERSIST_POLL = 2
+} persist_state_t;
+
+/* Write-behind cache */
+static uint32_t         persist_value[PERSIST_FIELD_COUNT];
+static volatile uint8_t persist_dirty;
+static volatile uint8_t persist_urgent;
+static uint8_t          persist_present;
+static uint8_t          persist_flash;      /* no EEPROM: flash store backend */
+static uint8_t          persist_flash_full; /* flash save waits for Persist_Maintain() */
+
+/* Save in progress */
+static volatile persist_state_t persist_state = PERSIST_IDLE;
+static uint8_t          persist_tx[PERSIST_RECORD_BYTES];
+static uint8_t          persist_addr[2];
+static i2c_xfer_t       persist_xfer;
+static i2c_xfer_t       persist_poll_xfer;
+static swtimer_t        persist_poll_timer;
+static uint32_t         persist_seq;
+static uint8_t          persist_slot;       /* slot holding the newest record */
+static uint8_t          persist_target;
+static uint16_t         persist_off;
+static uint16_t         persist_chunk;
+static uint8_t          persist_polls;
+
+static uint64_t         persist_last_save_us;
+static uint64_t         persist_minute_us;
+static uint64_t         persist_bod_us;
+static uint8_t          persist_bod_armed;
+static persist_stats_t  persist_stats;
+
+/* Boot-time read completion */
+static volatile uint8_t      persist_load_done;
+static volatile i2c_status_t persist_load_status;
+
+static void persist_write_chunk(void);
+static void persist_poll(void *ctx);
+
+static void persist_put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t persist_get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void persist_fail(void)
+{
+    persist_stats.errors++;
+    persist_dirty = 1U;      /* retried after the next wear interval */
+    persist_state = PERSIST_IDLE;
+}
+
+/* Serialise the cache and start writing it to the older slot.
+   Interrupts masked or ISR context */
+static void persist_begin(void)
+{
+    uint16_t crc;
+    uint8_t  i;
+
+    if ((persist_state != PERSIST_IDLE) || (persist_dirty == 0U) || (persist_present == 0U))
+    {
+        return;
+    }
+
+    persist_seq++;
+    persist_tx[0] = (uint8_t)PERSIST_VERSION;
+    persist_tx[1] = (uint8_t)(PERSIST_VERSION >> 8);
+    persist_put32(&persist_tx[PERSIST_OFS_SEQ], persist_seq);
+    for (i = 0U; i < (uint8_t)PERSIST_FIELD_COUNT; i++)
+    {
+        persist_put32(&persist_tx[PERSIST_OFS_VALUES + (4U * i)], persist_value[i]);
+    }
+    crc = Crc16_Ccitt(&persist_tx[PERSIST_OFS_SEQ], PERSIST_RECORD_BYTES - PERSIST_OFS_SEQ, CRC16_INIT);
+    persist_tx[PERSIST_OFS_CRC]      = (uint8_t)crc;
+    persist_tx[PERSIST_OFS_CRC + 1U] = (uint8_t)(crc >> 8);
+
+    persist_dirty  = 0U;
+    persist_urgent = 0U;
+    persist_target = (uint8_t)(persist_slot ^ 1U);
+    persist_off    = 0U;
+    persist_state  = PERSIST_WRITE;
+    persist_write_chunk();
+}
+
+/* I2C0 ISR: EEPROM acknowledged (write cycle over) or not yet */
+static void persist_poll_done(i2c_status_t status)
+{
+    if (status == I2C_STATUS_NACK)
+    {
+        persist_polls++;
+        if (persist_polls >= PERSIST_POLL_MAX)
+        {
+            persist_fail();
+        }
+        else
+        {
+            (void)SwTimer_Start(&persist_poll_timer, PERSIST_POLL_MS, 0U, persist_poll, NULL);
+        }
+        return;
+    }
+    if (status != I2C_STATUS_OK)
+    {
+        persist_fail();
+        return;
+    }
+
+    if (persist_off < PERSIST_RECORD_BYTES)
+    {
+        persist_state = PERSIST_WRITE;
+        persist_write_chunk();
+        return;
+    }
+
+    persist_slot  = persist_target;
+    persist_state = PERSIST_IDLE;
+    persist_stats.saves++;
+    if (persist_urgent != 0U)
+    {
+        persist_begin();   /* flush requested while this save was running */
+    }
+}
+
+/* TIMER0 ISR: address the EEPROM; it only acknowledges once the write is done */
+static void persist_poll(void *ctx)
+{
+    (void)ctx;
+    if (I2C_Start(&persist_poll_xfer, persist_poll_done) != I2C_STATUS_OK)
+    {
+        persist_fail();
+    }
+}
+
+/* I2C0 ISR: page data sent, the EEPROM now programs it */
+static void persist_write_done(i2c_status_t status)
+{
+    if (status != I2C_STATUS_OK)
+    {
+        persist_fail();
+        return;
+    }
+    persist_off   = (uint16_t)(persist_off + persist_chunk);
+    persist_polls = 0U;
+    persist_state = PERSIST_POLL;
+    (void)SwTimer_Start(&persist_poll_timer, PERSIST_POLL_MS, 0U, persist_poll, NULL);
+}
+
+/* Next chunk: up to the end of the current EEPROM page */
+static void persist_write_chunk(void)
+{
+    uint16_t addr  = (uint16_t)(PERSIST_SLOT_ADDR(persist_target) + persist_off);
+    uint16_t room  = (uint16_t)(PERSIST_EE_PAGE - (addr % PERSIST_EE_PAGE));
+    uint16_t left  = (uint16_t)(PERSIST_RECORD_BYTES - persist_off);
+
+    persist_chunk = (left < room) ? left : room;
+    persist_addr[0] = (uint8_t)(addr >> 8);
+    persist_addr[1] = (uint8_t)addr;
+
+    persist_xfer.addr7    = PERSIST_EE_ADDR7;
+    persist_xfer.head     = persist_addr;
+    persist_xfer.head_len = 2U;
+    persist_xfer.data     = &persist_tx[persist_off];
+    persist_xfer.data_len = persist_chunk;
+    persist_xfer.rx       = NULL;
+    persist_xfer.rx_len   = 0U;
+    if (I2C_Start(&persist_xfer, persist_write_done) != I2C_STATUS_OK)
+    {
+        persist_fail();
+    }
+}
+
+static void persist_load_cb(i2c_status_t status)
+{
+    persist_load_status = status;
+    persist_load_done   = 1U;
+}
+
+/* Blocking read of one slot; returns 1 if it holds a valid record */
+static uint8_t persist_read_slot(uint8_t slot, uint8_t *buf)
+{
+    uint64_t t0 = time_now_us();
+    uint16_t addr = PERSIST_SLOT_ADDR(slot);
+    uint16_t crc;
+
+    persist_addr[0]       = (uint8_t)(addr >> 8);
+    persist_addr[1]       = (uint8_t)addr;
+    persist_xfer.addr7    = PERSIST_EE_ADDR7;
+    persist_xfer.head     = persist_addr;
+    persist_xfer.head_len = 2U;
+    persist_xfer.data     = NULL;
+    persist_xfer.data_len = 0U;
+    persist_xfer.rx       = buf;
+    persist_xfer.rx_len   = PERSIST_RECORD_BYTES;
+
+    persist_load_done = 0U;
+    if (I2C_Start(&persist_xfer, persist_load_cb) != I2C_STATUS_OK)
+    {
+        return 0U;
+    }
+    while ((persist_load_done == 0U) && ((time_now_us() - t0) < PERSIST_LOAD_US))
+    {
+        /* boot only: the scheduler is not running yet */
+    }
+    if ((persist_load_done == 0U) || (persist_load_status != I2C_STATUS_OK))
+    {
+        return 0U;
+    }
+    persist_present = 1U;
+
+    crc = Crc16_Ccitt(&buf[PERSIST_OFS_SEQ], PERSIST_RECORD_BYTES - PERSIST_OFS_SEQ, CRC16_INIT);
+    return (((uint16_t)buf[0] | ((uint16_t)buf[1] << 8)) == PERSIST_VERSION) &&
+           (((uint16_t)buf[PERSIST_OFS_CRC] | ((uint16_t)buf[PERSIST_OFS_CRC + 1U] << 8)) == crc) ? 1U : 0U;
+}
+
+/* Flash backend save: page writes with interrupts briefly masked */
+static void persist_flash_save(void)
+{
+    flash_kv_status_t st;
+    uint8_t i;
+
+    persist_dirty = 0U;
+    for (i = 0U; i < (uint8_t)PERSIST_FIELD_COUNT; i++)
+    {
+        (void)Flash_KV_Set(i, persist_value[i]);
+    }
+    st = Flash_KV_Flush();
+    persist_flash_full = (st == FLASH_KV_STATUS_FULL) ? 1U : 0U;
+    if (st == FLASH_KV_STATUS_OK)
+    {
+        persist_stats.saves++;
+    }
+    else
+    {
+        persist_fail();
+    }
+}
+
+void Persist_Init(void)
+{
+    static uint8_t rec[2][PERSIST_RECORD_BYTES];
+    uint8_t  valid[2];
+    uint8_t  best;
+    uint8_t  i;
+
+    I2C_Init();
+    persist_present = 0U;
+    persist_state   = PERSIST_IDLE;
+    persist_poll_xfer.addr7    = PERSIST_EE_ADDR7;
+    persist_poll_xfer.head     = NULL;
+    persist_poll_xfer.head_len = 0U;
+    persist_poll_xfer.data     = NULL;
+    persist_poll_xfer.data_len = 0U;
+    persist_poll_xfer.rx       = NULL;
+    persist_poll_xfer.rx_len   = 0U;
+
+    valid[0] = persist_read_slot(0U, rec[0]);
+    valid[1] = persist_read_slot(1U, rec[1]);
+
+    /* Newest valid slot by sequence number (wrap-safe) */
+    if ((valid[0] != 0U) && (valid[1] != 0U))
+    {
+        int32_t d = (int32_t)(persist_get32(&rec[1][PERSIST_OFS_SEQ]) - persist_get32(&rec[0][PERSIST_OFS_SEQ]));
+        best = (d > 0) ? 1U : 0U;
+    }
+    else
+    {
+        best = (valid[1] != 0U) ? 1U : 0U;
+    }
+
+    persist_flash      = 0U;
+    persist_flash_full = 0U;
+    if ((persist_present == 0U) && (Flash_KV_Init() == FLASH_KV_STATUS_OK))
+    {
+        persist_flash = 1U;
+        for (i = 0U; i < (uint8_t)PERSIST_FIELD_COUNT; i++)
+        {
+            if (Flash_KV_Get(i, &persist_value[i]) != FLASH_KV_STATUS_OK)
+            {
+                persist_value[i] = 0U;
+            }
+        }
+    }
+    else if (valid[best] != 0U)
+    {
+        persist_slot = best;
+        persist_seq  = persist_get32(&rec[best][PERSIST_OFS_SEQ]);
+        for (i = 0U; i < (uint8_t)PERSIST_FIELD_COUNT; i++)
+        {
+            persist_value[i] = persist_get32(&rec[best][PERSIST_OFS_VALUES + (4U * i)]);
+        }
+    }
+    else
+    {
+        /* Defaults; the first save goes to slot 0 */
+        persist_slot = 1U;
+        persist_seq  = 0U;
+        for (i = 0U; i < (uint8_t)PERSIST_FIELD_COUNT; i++)
+        {
+            persist_value[i] = 0U;
+        }
+    }
+
+    persist_stats.saves     = 0U;
+    persist_stats.errors    = 0U;
+    persist_stats.brownouts = 0U;
+    persist_last_save_us    = time_now_us();
+    persist_minute_us       = persist_last_save_us + PERSIST_MINUTE_US;
+
+    /* Brown-out: interrupt at ~2.2 V, ahead of the BOD reset */
+    LPC_SC->PCON &= ~((1UL << 3) | (1UL << 4));   /* BOGD = 0, BORD = 0 */
+    NVIC_ClearPendingIRQ(BOD_IRQn);
+    NVIC_EnableIRQ(BOD_IRQn);
+    persist_bod_armed = 1U;
+
+    (void)Persist_Add(PERSIST_POWER_ON_COUNT, 1U);
+    if (persist_flash != 0U)
+    {
+        persist_flash_save();
+    }
+    else
+    {
+        Persist_Flush_Now();
+    }
+}
+
+void Persist_Maintain(void)
+{
+    if (persist_flash == 0U)
+    {
+        return;
+    }
+    if (Flash_KV_Maintain() != FLASH_KV_STATUS_OK)
+    {
+        persist_stats.errors++;
+    }
+    else if (persist_flash_full != 0U)
+    {
+        persist_flash_save();   /* compacts into the sector just erased */
+    }
+    else
+    {
+        /* Spare already blank: nothing to do */
+    }
+}
+
+void Persist_Update(uint64_t now_us)
+{
+    uint32_t primask;
+
+    while (now_us >= persist_minute_us)
+    {
+        (void)Persist_Add(PERSIST_RUNTIME_MIN, 1U);
+        persist_minute_us += PERSIST_MINUTE_US;
+    }
+
+    if ((persist_dirty != 0U) && (persist_flash != 0U) &&
+        ((now_us - persist_last_save_us) >= ((uint64_t)PERSIST_FLASH_SAVE_MS * 1000U)))
+    {
+        persist_last_save_us = now_us;
+        persist_flash_save();
+    }
+    else if ((persist_dirty != 0U) && (persist_flash == 0U) &&
+             ((now_us - persist_last_save_us) >= ((uint64_t)PERSIST_MIN_SAVE_MS * 1000U)))
+    {
+        persist_last_save_us = now_us;
+        primask = Critical_Enter();
+        persist_begin();
+        Critical_Exit(primask);
+    }
+
+    /* Re-arm the detector after a dip; it fires again at once if still low */
+    if ((persist_bod_armed == 0U) && ((now_us - persist_bod_us) >= PERSIST_BOD_REARM_US))
+    {
+        persist_bod_armed = 1U;
+        NVIC_ClearPendingIRQ(BOD_IRQn);
+        NVIC_EnableIRQ(BOD_IRQn);
+    }
+}
+
+persist_status_t Persist_Set(persist_field_t f, uint32_t value)
+{
+    uint32_t primask;
+
+    if ((uint32_t)f >= (uint32_t)PERSIST_FIELD_COUNT)
+    {
+        return PERSIST_STATUS_INVALID_PARAM;
+    }
+    primask = Critical_Enter();
+    if (persist_value[f] != value)
+    {
+        persist_value[f] = value;
+        persist_dirty    = 1U;
+    }
+    Critical_Exit(primask);
+    return PERSIST_STATUS_OK;
+}
+
+persist_status_t Persist_Add(persist_field_t f, uint32_t delta)
+{
+    uint32_t primask;
+
+    if ((uint32_t)f >= (uint32_t)PERSIST_FIELD_COUNT)
+    {
+        return PERSIST_STATUS_INVALID_PARAM;
+    }
+    if (delta != 0U)
+    {
+        primask = Critical_Enter();
+        persist_value[f] += delta;
+        persist_dirty     = 1U;
+        Critical_Exit(primask);
+    }
+    return PERSIST_STATUS_OK;
+}
+
+uint32_t Persist_Get(persist_field_t f)
+{
+    return ((uint32_t)f < (uint32_t)PERSIST_FIELD_COUNT) ? persist_value[f] : 0U;
+}
+
+void Persist_Flush_Now(void)
+{
+    uint32_t primask = Critical_Enter();
+
+    if (persist_state != PERSIST_IDLE)
+    {
+        persist_urgent = 1U;   /* the save in flight starts this one when done */
+    }
+    else
+    {
+        persist_begin();
+    }
+    Critical_Exit(primask);
+}
+
+uint8_t Persist_Busy(void)
+{
+    return (persist_state != PERSIST_IDLE) ? 1U : 0U;
+}
+
+void Persist_Get_Stats(persist_stats_t *out)
+{
+    if (out != NULL)
+    {
+        *out = persist_stats;
+    }
+}
+
+/* Supply is falling: save now. The interrupt stays asserted while the
+   supply is low, so it is masked until Persist_Update() re-arms it */
+void BOD_IRQHandler(void)
+{
+    NVIC_DisableIRQ(BOD_IRQn);
+    persist_bod_us    = time_now_us();
+    persist_bod_armed = 0U;
+    persist_stats.brownouts++;
+    Persist_Flush_Now();
+}
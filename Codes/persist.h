@@ -0,0 +1,103 @@
+/*
+ * File: persist.h
+ * Purpose: Write-behind persistence of service, odometer and trip data (MISRA C:2012 aligned)
+ *
+ * Implements the EEPROM section of Plans/Indicators logic/codex_pseudocode.c
+ * on a 24LC256 (I2C0, 64-byte pages) without blocking. Setters only update
+ * a RAM copy; however often they change, a save writes the latest record
+ * once, as page-aligned page writes. The 5 ms write cycle is awaited by
+ * ACK polling from a software timer, so the whole save runs in interrupt
+ * context and no task ever waits on the EEPROM.
+ *
+ * The record alternates between two page-aligned slots with a sequence
+ * number, so a save cut short by power loss leaves the previous record
+ * valid. Saves are spaced by PERSIST_MIN_SAVE_MS for wear; a brown-out
+ * skips that wait and starts a save at once (or right after the one in
+ * flight), so the last values reach the EEPROM while the supply holds up.
+ *
+ * Boards without the EEPROM (no answer at boot) use the internal flash
+ * store (flash_kv.h) instead. Its saves are spaced by PERSIST_FLASH_SAVE_MS,
+ * so a sector lasts about ten hours before compaction, and are not done on
+ * brown-out: flash programming is only specified down to 2.4 V.
+ * A compaction leaves the old sector to be erased before the next one;
+ * that erase masks interrupts for up to FLASH_KV_ERASE_MAX_US, so it is
+ * left to Persist_Maintain(), which the application calls only at quiet
+ * points (vehicle stopped). Until then a full sector fails the saves and
+ * the values wait in RAM; the next Persist_Maintain() saves them.
+ */
+
+#ifndef PERSIST_H
+#define PERSIST_H
+
+#include <stdint.h>
+
+/* Status codes for persistence APIs */
+typedef enum
+{
+    PERSIST_STATUS_OK = 0,
+    PERSIST_STATUS_INVALID_PARAM = 1
+} persist_status_t;
+
+/* Stored values, all uint32_t */
+typedef enum
+{
+    PERSIST_POWER_ON_COUNT = 0,
+    PERSIST_RUNTIME_MIN = 1,
+    PERSIST_SERVICE_COUNT = 2,
+    PERSIST_LAST_SERVICE_TS = 3,
+    PERSIST_ODOMETER_M = 4,
+    PERSIST_TRIP_M = 5,
+    PERSIST_FIELD_COUNT = 6
+} persist_field_t;
+
+#define PERSIST_VERSION                   (1U)
+
+/* 24LC256 */
+#define PERSIST_EE_ADDR7                  (0x50U)
+#define PERSIST_EE_PAGE                   (64U)
+#define PERSIST_EE_WRITE_MS               (5U)      /* tWR, max */
+
+/* Two slots of whole pages */
+#define PERSIST_RECORD_BYTES              (8U + (4U * (uint32_t)PERSIST_FIELD_COUNT))
+#define PERSIST_SLOT_BYTES                (((PERSIST_RECORD_BYTES + PERSIST_EE_PAGE - 1U) / PERSIST_EE_PAGE) * PERSIST_EE_PAGE)
+#define PERSIST_SLOT_ADDR(s)              ((uint16_t)((s) * PERSIST_SLOT_BYTES))
+
+/* Wear limit between saves, and how often Persist_Update() must run */
+#define PERSIST_MIN_SAVE_MS               (60000U)
+#define PERSIST_UPDATE_MS                 (100U)
+#define PERSIST_FLASH_SAVE_MS             (300000U)
+
+/* ACK polling: interval and give-up time for one page write */
+#define PERSIST_POLL_MS                   (1U)
+#define PERSIST_POLL_MAX                  (20U)
+
+/* Save statistics since power-up */
+typedef struct
+{
+    uint32_t saves;          /* records completely written */
+    uint32_t errors;         /* saves abandoned (NACK, bus error, timeout) */
+    uint32_t brownouts;      /* saves forced by the brown-out detector */
+} persist_stats_t;
+
+/* Public API (main context unless noted) */
+/* Load the newest valid record (defaults if none), count the power-on and
+   queue a save. Blocks for the two slot reads, or for the flash store's
+   boot erase; call before the scheduler */
+void             Persist_Init(void);
+/* Wear-limited save and runtime minutes; call every PERSIST_UPDATE_MS */
+void             Persist_Update(uint64_t now_us);
+persist_status_t Persist_Set(persist_field_t f, uint32_t value);
+persist_status_t Persist_Add(persist_field_t f, uint32_t delta);
+uint32_t         Persist_Get(persist_field_t f);
+/* Flash backend: erase the sector left by a compaction, then save if a
+   save was held up by it. Masks interrupts up to FLASH_KV_ERASE_MAX_US
+   once per compaction; call only when that stall is acceptable */
+void             Persist_Maintain(void);
+/* EEPROM: save at once, bypassing the wear limit (main or ISR context) */
+void             Persist_Flush_Now(void);
+uint8_t          Persist_Busy(void);
+void             Persist_Get_Stats(persist_stats_t *out);
+
+void BOD_IRQHandler(void);
+
+#endif /* PERSIST_H */
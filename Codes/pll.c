@@ -13,8 +13,12 @@ pll_status_t PLL_Init(void)
 {
     uint32_t timeout = OSC_READY_TIMEOUT_CYCLES;
 
-    /* Select proper range for your crystal: 0 => 1-20 MHz (typical 12 MHz) */
+    /* Select proper range for the planned crystal: 0 => 1-20 MHz (typical 12 MHz) */
     LPC_SC->SCS &= ~SCS_OSCRANGE;
+    if (CLOCK_PLAN_OSCRANGE_HIGH != 0UL)
+    {
+        LPC_SC->SCS |= SCS_OSCRANGE;
+    }
     
     /* Enable the main oscillator */
     LPC_SC->SCS |= SCS_OSCEN;
@@ -53,7 +57,7 @@ pll_status_t PLL_Init(void)
     {
         return PLL_ERR_OSC_TIMEOUT;
     }
-    /* Set CPU clock divider to 3 */
+    /* Set CPU clock divider from the clock plan */
     LPC_SC->CCLKCFG = CCLKCFG_CCLKSEL;
 
     /* Connect PLL now that it is locked */
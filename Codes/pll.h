@@ -6,6 +6,8 @@
 #ifndef PLL_H
 #define PLL_H
 
+#include "clock_plan.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -19,15 +21,15 @@ extern "C" {
 #define CLKSRCSEL_CLKSRC0   (1U << 0U)               /* Selecting pll clock source*/
 #define CLKSRCSEL_CLKSRC1   (1U << 1U)               
 
-#define PLL0CFG_MSEL0       (24U << 0U)               /* PLL0 mutiplier value */
-#define PLL0CFG_NSEL0       (1U << 16U)               /* PLL0 predivider rule*/
+#define PLL0CFG_MSEL0       ((CLOCK_PLAN_PLL0_M - 1UL) << 0U)   /* PLL0 mutiplier value */
+#define PLL0CFG_NSEL0       ((CLOCK_PLAN_PLL0_N - 1UL) << 16U)  /* PLL0 predivider rule*/
 
 /* PLL0 control and status */
 #define PLL0CON_PLLE0       (1U << 0U)                /* Enable PLL0 */
 #define PLL0CON_PLLC0       (1U << 1U)                /* Connect PLL0 */
 #define PLL0STAT_PLOCK0     (1U << 26U)               /* PLL0 lock status */
 
-#define CCLKCFG_CCLKSEL     (0x02U)                 /* CPU clock divider = 3 */
+#define CCLKCFG_CCLKSEL     (CLOCK_PLAN_CCLK_DIV - 1UL)  /* CPU clock divider */
 
 /* PLL0 feed sequence constants (avoid magic numbers) */
 #define PLL0_FEED_SEQ_1     (0xAAU)
@@ -2,57 +2,152 @@
 #include "timer.h"
 #include "pwm.h"
 
+/* Instrumentation: the tone path is meant to run with PWM1 interrupts off.
+ * Before: MR0 + MR1 interrupts toggled P2.11 in software, 2 IRQs per
+ * period = 2 * PWM1_TONE_HZ (about 3030 IRQ/s) while a tone played.
+ * After: the PWM1.1 match output drives the pin, 0 IRQ/s.
+ */
+static volatile uint32_t pwm1_irq_count = 0U;
+
+/* Last values written, so unchanged requests cost no bus writes */
+static uint32_t pwm_period = PWM1_PERIOD_MR0_TICKS;
+static uint32_t pwm_on     = PWM1_DUTY_MR1_TICKS;
+static uint8_t  pwm_enabled = 0U;
+static uint16_t pwm_lamp_duty = 0U;
+
+/* Single-edge PWM1.2 is set at each period start and cleared at MR2:
+   MR2 = 0 never sets it (/OE low, lamps fully on), MR2 beyond MR0 never
+   clears it (/OE high, dark). Otherwise /OE is high for MR2 ticks */
+static uint32_t pwm_lamp_mr2(uint32_t period)
+{
+    if (pwm_lamp_duty == 0xFFFFU)
+    {
+        return 0U;
+    }
+    if (pwm_lamp_duty == 0U)
+    {
+        return period + 1U;
+    }
+    return period - (uint32_t)(((uint64_t)period * pwm_lamp_duty) >> 16);
+}
+
 void PWM_Init(void)
 {
     /* Enable power/clock for PWM1 */
     LPC_SC->PCONP |= PCONP_PCPWM1_MASK;
 
-    /* Ensure P2.11 is GPIO (PINSEL4 bits 23:22 = 00) and do not enable PWM1.1 on P2.0 */
-    LPC_PINCON->PINSEL4 &= ~(PINSEL4_P2_11_MASK | PINSEL4_P2_00_MASK);
+    /* PWM1 PCLK divider from the clock plan */
+    LPC_SC->PCLKSEL0 &= ~PCLKSEL0_PCLK_PWM1_MASK;
+    LPC_SC->PCLKSEL0 |=  PCLKSEL0_PCLK_PWM1_PLAN;
 
     /* Set prescaler (before starting timer) */
     LPC_PWM1->PR = PWM1_PRESCALE_VALUE;
 
-    /* Enable reset on MR0 match (MCR bit 1) */
+    /* Reset on MR0 match only; no match interrupts */
     LPC_PWM1->MCR = PWM_MCR_RESET_ON_MR0_MASK;
 
     /* Set period (MR0) and duty (MR1) */
-    LPC_PWM1->MR0 = PWM1_PERIOD_MR0_TICKS;
-	LPC_PWM1->MR1 = PWM1_DUTY_MR1_TICKS;
-	
+    pwm_period = PWM1_PERIOD_MR0_TICKS;
+    pwm_on     = PWM1_DUTY_MR1_TICKS;
+    LPC_PWM1->MR0 = pwm_period;
+    LPC_PWM1->MR1 = pwm_on;
 
-    /* Latch both MR0 and MR1 updates */
-    LPC_PWM1->LER = (PWM_LER_EN_MR0_MASK | PWM_LER_EN_MR1_MASK);
+    /* Lamp /OE starts dark (SPI_Init already holds P2.1 high) */
+    pwm_lamp_duty = 0U;
+    LPC_PWM1->MR2 = pwm_lamp_mr2(pwm_period);
 
-    /* Pure timer/interrupt usage; no PWM output channel needed */
+    /* Latch MR0..MR2 updates */
+    LPC_PWM1->LER = (PWM_LER_EN_MR0_MASK | PWM_LER_EN_MR1_MASK | PWM_LER_EN_MR2_MASK);
 
-    /* Enable interrupt on MR0 and MR1 match */
-    LPC_PWM1->MCR |= (PWM_MCR_INT_ON_MR0_MASK | PWM_MCR_INT_ON_MR1_MASK);
+    /* Single-edge PWM1.1 held off until a tone is enabled; single-edge
+       PWM1.2 always enabled, it owns /OE from here on */
+    pwm_enabled   = 0U;
+    LPC_PWM1->PCR = PWM_PCR_PWMENA2_MASK;
 
-    /* Enable PWM1 interrupt in NVIC */
-    NVIC_EnableIRQ(PWM1_IRQn);
+    /* P2.0 as PWM1.1 (PINSEL4 bits 1:0 = 01) */
+    LPC_PINCON->PINSEL4 &= ~PINSEL4_P2_00_MASK;
+    LPC_PINCON->PINSEL4 |=  PINSEL4_P2_00_PWM1_1;
 
-    /* Enable PWM1 interrupt in NVIC */
-    //__enable_irq();
+    /* Nothing to service: keep the vector quiet */
+    LPC_PWM1->IR = (PWM_IR_MR0_MASK | PWM_IR_MR1_MASK);
+    NVIC_DisableIRQ(PWM1_IRQn);
 
-    /* Start timer and PWM last */
+    /* Start timer and PWM last; it free-runs from here on */
     LPC_PWM1->TCR = (PWM_TCR_COUNTER_ENABLE_MASK | PWM_TCR_PWM_ENABLE_MASK);
-} 
-
-void PWM1_IRQHandler(void) 
-{	 
-	if ((LPC_PWM1->IR & PWM_IR_MR0_MASK) != 0U)
-	{
-		/* MR0: drive LOW (buzzer ON) */
-		LPC_GPIO2->FIOCLR = BUZZER_GPIO_P2_11_MASK;
-		/* Clear only MR0 flag */
-		LPC_PWM1->IR |= PWM_IR_MR0_MASK;
-	}
-	else if ((LPC_PWM1->IR & PWM_IR_MR1_MASK) != 0U)
-	{
-		/* MR1: drive HIGH (buzzer OFF) */
-		LPC_GPIO2->FIOSET = BUZZER_GPIO_P2_11_MASK;
-		/* Clear only MR1 flag */
-		LPC_PWM1->IR |= PWM_IR_MR1_MASK;
-	}	
+
+    /* Hand P2.1 from GPIO to PWM1.2 once it is driving (PINSEL4 bits 3:2 = 01) */
+    LPC_PINCON->PINSEL4 &= ~PINSEL4_P2_01_MASK;
+    LPC_PINCON->PINSEL4 |=  PINSEL4_P2_01_PWM1_2;
+}
+
+void PWM_Buzzer_Set(uint32_t period_ticks, uint32_t on_ticks)
+{
+    uint32_t ler = 0U;
+
+    if ((period_ticks < 2U) || (on_ticks > period_ticks))
+    {
+        return;
+    }
+
+    if (period_ticks != pwm_period)
+    {
+        pwm_period    = period_ticks;
+        LPC_PWM1->MR0 = period_ticks;
+        LPC_PWM1->MR2 = pwm_lamp_mr2(period_ticks); /* keep the lamp duty */
+        ler |= (PWM_LER_EN_MR0_MASK | PWM_LER_EN_MR2_MASK);
+    }
+    if (on_ticks != pwm_on)
+    {
+        pwm_on        = on_ticks;
+        LPC_PWM1->MR1 = on_ticks;
+        ler |= PWM_LER_EN_MR1_MASK;
+    }
+    if (ler != 0U)
+    {
+        /* OR in: a lamp MR2 latch still pending must not be dropped */
+        LPC_PWM1->LER |= ler; /* applied together at the next period start */
+    }
+}
+
+void PWM_Buzzer_Enable(uint8_t on)
+{
+    uint8_t want = (on != 0U) ? 1U : 0U;
+
+    if (want == pwm_enabled)
+    {
+        return;
+    }
+    pwm_enabled = want;
+    if (want != 0U)
+    {
+        LPC_PWM1->PCR |= PWM_PCR_PWMENA1_MASK;
+    }
+    else
+    {
+        LPC_PWM1->PCR &= ~PWM_PCR_PWMENA1_MASK;
+    }
+}
+
+void PWM_Lamp_Set_Duty(uint16_t on_q16)
+{
+    if (on_q16 == pwm_lamp_duty)
+    {
+        return;
+    }
+    pwm_lamp_duty = on_q16;
+    LPC_PWM1->MR2 = pwm_lamp_mr2(pwm_period);
+    /* OR in: buzzer MR0/MR1 latches still pending must not be dropped */
+    LPC_PWM1->LER |= PWM_LER_EN_MR2_MASK; /* applied at the next period start */
+}
+
+uint32_t PWM_Irq_Count(void)
+{
+    return pwm1_irq_count;
+}
+
+void PWM1_IRQHandler(void)
+{
+	/* Not expected: count it so a stray enable shows up, then clear */
+	pwm1_irq_count++;
+	LPC_PWM1->IR = (PWM_IR_MR0_MASK | PWM_IR_MR1_MASK);
 }
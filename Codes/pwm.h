@@ -6,19 +6,47 @@
 #ifndef PWM_H
 #define PWM_H
 
+#include <stdint.h>
+#include "clock_plan.h"
+
 /* Macros moved from source to header per requirement */
 
 /* PCONP bit for PWM1 peripheral clock */
 #define PCONP_PCPWM1_MASK             (1UL << 6)
 
-/* PINSEL4 masks: ensure P2.11 is GPIO and do not enable PWM1.1 on P2.0 */
-#define PINSEL4_P2_11_MASK            (3UL << 22)
+/* PCLKSEL0 field for PWM1 (bits [13:12]) */
+#define PCLKSEL0_PCLK_PWM1_MASK       (3UL << 12)
+#define PCLKSEL0_PCLK_PWM1_PLAN       (CLOCK_PLAN_PCLKSEL_BITS << 12)
+
+/* PINSEL4: buzzer on P2.0 as PWM1.1 (bits 1:0 = 01); P2.11 no longer used */
 #define PINSEL4_P2_00_MASK            (3UL << 0)
+#define PINSEL4_P2_00_PWM1_1          (1UL << 0)
+
+/* PINSEL4: 74HC595 /OE on P2.1 as PWM1.2 (bits 3:2 = 01) */
+#define PINSEL4_P2_01_MASK            (3UL << 2)
+#define PINSEL4_P2_01_PWM1_2          (1UL << 2)
+
+/* PWM1 timing configuration (tone frequency in Hz, ticks from the clock plan) */
+#define PWM1_TONE_HZ                  (1515UL)
+#define PWM1_PRESCALE_VALUE           (CLOCK_PLAN_PWM1_PRESCALE)
+#define PWM1_PERIOD_MR0_TICKS         (CLOCK_PLAN_PWM1_TICKS(PWM1_TONE_HZ))
+/* Duty as a fraction num/den of the period */
+#define PWM1_DUTY_TICKS(num, den)     ((PWM1_PERIOD_MR0_TICKS * (num)) / (den))
+#define PWM1_DUTY_MR1_TICKS           (PWM1_DUTY_TICKS(14UL, 15UL))
 
-/* PWM1 timing configuration */
-#define PWM1_PRESCALE_VALUE           (10UL)
-#define PWM1_PERIOD_MR0_TICKS         (1500UL)
-#define PWM1_DUTY_MR1_TICKS           (1400UL)
+/* At least one tick per permille, so every chime duty_permille step is its
+   own MR1 value and the lamp duty keeps 1/1000 resolution on MR2 */
+#define PWM1_PERIOD_MIN_TICKS         (1000UL)
+
+#if (PWM1_PERIOD_MR0_TICKS < PWM1_PERIOD_MIN_TICKS)
+#error "pwm: tone period too short for permille duty steps, lower CLOCK_PLAN_PWM1_PRESCALE"
+#endif
+
+/* PWM1 Control Register (PCR) bits */
+#define PWM_PCR_PWMSEL1_MASK          (1UL << 1)   /* 0 = single-edge (MR0/MR1) */
+#define PWM_PCR_PWMSEL2_MASK          (1UL << 2)   /* 0 = single-edge (MR0/MR2) */
+#define PWM_PCR_PWMENA1_MASK          (1UL << 9)   /* PWM1.1 output enable */
+#define PWM_PCR_PWMENA2_MASK          (1UL << 10)  /* PWM1.2 output enable */
 
 /* PWM1 Match Control Register (MCR) bits */
 #define PWM_MCR_INT_ON_MR0_MASK       (1UL << 0)
@@ -28,6 +56,7 @@
 /* PWM1 Latch Enable Register (LER) bits */
 #define PWM_LER_EN_MR0_MASK           (1UL << 0)
 #define PWM_LER_EN_MR1_MASK           (1UL << 1)
+#define PWM_LER_EN_MR2_MASK           (1UL << 2)
 
 /* PWM1 Timer Control Register (TCR) bits */
 #define PWM_TCR_COUNTER_ENABLE_MASK   (1UL << 0)
@@ -37,11 +66,21 @@
 #define PWM_IR_MR0_MASK               (1UL << 0)
 #define PWM_IR_MR1_MASK               (1UL << 1)
 
-/* Buzzer GPIO (P2.11) mask */
-#define BUZZER_GPIO_P2_11_MASK        (1UL << 11)
-
 /* Public API */
-void PWM_Init(void);
-void PWM1_IRQHandler(void);
+/* PWM1 free-runs at the tone period; the buzzer (active-high driver on
+   P2.0) is gated by the PWM1.1 output enable, so tones take no interrupts */
+void     PWM_Init(void);
+/* Period and high time in PWM1 ticks; registers touched only on change and
+   latched at the next period start */
+void     PWM_Buzzer_Set(uint32_t period_ticks, uint32_t on_ticks);
+/* Non-zero connects PWM1.1 to the pin, zero holds it low (silent) */
+void     PWM_Buzzer_Enable(uint8_t on);
+/* Lamp brightness: PWM1.2 drives the 74HC595 /OE (active low) at the
+   tone period; on_q16 is the share of each period the lamps are lit,
+   0 => dark, 0xFFFF => always on. MR2 follows tone period changes */
+void     PWM_Lamp_Set_Duty(uint16_t on_q16);
+/* PWM1 interrupts taken since reset; expected to stay 0 */
+uint32_t PWM_Irq_Count(void);
+void     PWM1_IRQHandler(void);
 
 #endif /* PWM_H */
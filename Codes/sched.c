@@ -0,0 +1,242 @@
+/*
+ * File: sched.c
+ * Purpose: Priority-ordered dispatch of periodic and event tasks with idle sleep.
+ * Notes: The runnable check and __WFI() happen with PRIMASK set. A pending
+ *        interrupt still wakes the core, so a kick or deadline that lands
+ *        between the check and the sleep cannot be slept through; the ISR
+ *        runs as soon as PRIMASK is restored.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "sched.h"
+#include "systime.h"
+#include "critical.h"
+
+typedef struct
+{
+    sched_fn_t    fn;
+    void         *ctx;
+    uint64_t      next_us;      /* next release, periodic tasks only */
+    uint32_t      period_us;    /* 0 => event task */
+    uint8_t       prio;
+    uint8_t       pending;      /* event task released by a kick */
+    sched_stats_t stats;
+} sched_task_t;
+
+static sched_task_t     sched_tasks[SCHED_MAX_TASKS];
+static uint8_t          sched_count = 0U;
+static volatile uint8_t sched_kicked = 0U;
+static deadline_t       sched_wake;
+static uint64_t         sched_idle_us = 0U;
+static uint64_t         sched_stats_since_us = 0U;
+
+static void sched_wake_cb(void *ctx)
+{
+    (void)ctx; /* only here to end __WFI */
+}
+
+void Sched_Init(void)
+{
+    sched_count          = 0U;
+    sched_kicked         = 1U; /* first pass runs every event task once */
+    sched_idle_us        = 0U;
+    sched_stats_since_us = time_now_us();
+}
+
+sched_status_t Sched_Add(sched_fn_t fn, void *ctx, uint32_t period_ms,
+                         uint32_t offset_ms, uint8_t prio, uint8_t *id)
+{
+    sched_task_t *t;
+
+    if ((fn == NULL) || (period_ms > (0xFFFFFFFFUL / 1000U)))
+    {
+        return SCHED_STATUS_INVALID_PARAM;
+    }
+    if (sched_count >= SCHED_MAX_TASKS)
+    {
+        return SCHED_STATUS_FULL;
+    }
+
+    t = &sched_tasks[sched_count];
+    t->fn        = fn;
+    t->ctx       = ctx;
+    t->period_us = period_ms * 1000U;
+    t->next_us   = time_now_us() + ((uint64_t)offset_ms * 1000U);
+    t->prio      = prio;
+    t->pending   = 0U;
+    t->stats.runs     = 0U;
+    t->stats.overruns = 0U;
+    t->stats.total_us = 0U;
+    t->stats.max_us   = 0U;
+    if (id != NULL)
+    {
+        *id = sched_count;
+    }
+    sched_count++;
+    return SCHED_STATUS_OK;
+}
+
+void Sched_Kick(void)
+{
+    sched_kicked = 1U;
+}
+
+/* Highest-priority runnable task; ties go to the earlier registration.
+   Also reports the earliest periodic release for the idle timer */
+static sched_task_t *sched_pick(uint64_t now, uint64_t *earliest)
+{
+    sched_task_t *best = NULL;
+    uint8_t i;
+
+    *earliest = 0xFFFFFFFFFFFFFFFFULL;
+    for (i = 0U; i < sched_count; i++)
+    {
+        sched_task_t *t = &sched_tasks[i];
+        uint8_t ready;
+
+        if (t->period_us == 0U)
+        {
+            ready = t->pending;
+        }
+        else
+        {
+            ready = (now >= t->next_us) ? 1U : 0U;
+            if (t->next_us < *earliest)
+            {
+                *earliest = t->next_us;
+            }
+        }
+        if ((ready != 0U) && ((best == NULL) || (t->prio < best->prio)))
+        {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static void sched_dispatch(sched_task_t *t, uint64_t now)
+{
+    uint64_t end;
+    uint32_t run_us;
+
+    if (t->period_us == 0U)
+    {
+        t->pending = 0U;
+    }
+    else
+    {
+        /* Keep the phase; if we are late by whole periods, skip them */
+        uint64_t late = now - t->next_us;
+        if (late >= t->period_us)
+        {
+            uint64_t missed = late / t->period_us;
+            t->stats.overruns += (uint32_t)missed;
+            t->next_us += missed * t->period_us;
+        }
+        t->next_us += t->period_us;
+    }
+
+    t->fn(t->ctx);
+
+    end    = time_now_us();
+    run_us = (uint32_t)(end - now);
+    t->stats.runs++;
+    t->stats.total_us += run_us;
+    if (run_us > t->stats.max_us)
+    {
+        t->stats.max_us = run_us;
+    }
+}
+
+/* Turn a kick into one pending run of every event task */
+static void sched_collect_kick(void)
+{
+    uint8_t i;
+
+    if (sched_kicked != 0U)
+    {
+        sched_kicked = 0U;
+        for (i = 0U; i < sched_count; i++)
+        {
+            if (sched_tasks[i].period_us == 0U)
+            {
+                sched_tasks[i].pending = 1U;
+            }
+        }
+    }
+}
+
+static void sched_idle(uint64_t earliest)
+{
+    uint32_t primask;
+
+    if (earliest != 0xFFFFFFFFFFFFFFFFULL)
+    {
+        Deadline_Set_At(&sched_wake, earliest);
+        (void)Deadline_Await(&sched_wake, sched_wake_cb, NULL);
+    }
+
+    primask = Critical_Enter();
+    if ((sched_kicked == 0U) && (time_now_us() < earliest))
+    {
+        uint64_t t0 = time_now_us();
+        __WFI();
+        sched_idle_us += time_now_us() - t0;
+    }
+    Critical_Exit(primask); /* the waking ISR runs here */
+}
+
+void Sched_Run(void)
+{
+    for (;;)
+    {
+        uint64_t      earliest;
+        uint64_t      now;
+        sched_task_t *t;
+
+        sched_collect_kick();
+        now = time_now_us();
+        t   = sched_pick(now, &earliest);
+        if (t != NULL)
+        {
+            sched_dispatch(t, now);
+        }
+        else
+        {
+            sched_idle(earliest);
+        }
+    }
+}
+
+sched_status_t Sched_Get_Stats(uint8_t id, sched_stats_t *out)
+{
+    if ((id >= sched_count) || (out == NULL))
+    {
+        return SCHED_STATUS_INVALID_PARAM;
+    }
+    *out = sched_tasks[id].stats;
+    return SCHED_STATUS_OK;
+}
+
+uint16_t Sched_Idle_Permille(void)
+{
+    uint64_t span = time_now_us() - sched_stats_since_us;
+    return (span == 0U) ? 0U : (uint16_t)((sched_idle_us * 1000U) / span);
+}
+
+void Sched_Reset_Stats(void)
+{
+    uint8_t i;
+
+    for (i = 0U; i < sched_count; i++)
+    {
+        sched_tasks[i].stats.runs     = 0U;
+        sched_tasks[i].stats.overruns = 0U;
+        sched_tasks[i].stats.total_us = 0U;
+        sched_tasks[i].stats.max_us   = 0U;
+    }
+    sched_idle_us        = 0U;
+    sched_stats_since_us = time_now_us();
+}
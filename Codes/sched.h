@@ -0,0 +1,61 @@
+/*
+ * File: sched.h
+ * Purpose: Cooperative run-to-completion task scheduler (MISRA C:2012 aligned)
+ *
+ * Each task has a period, a start offset and a priority (0 = highest).
+ * The highest-priority task that is due runs to completion, then the
+ * choice is made again. Tasks with period 0 are event tasks: they run once
+ * after every Sched_Kick(), which producers call from ISRs after posting
+ * work. When nothing is runnable the core sleeps in __WFI() until the next
+ * periodic deadline or any interrupt. Runtime per task and the idle share
+ * are measured on the 64-bit microsecond time base.
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+
+/* Task table size */
+#define SCHED_MAX_TASKS                   (12U)
+
+#define SCHED_PRIO_HIGHEST                (0U)
+#define SCHED_PRIO_LOWEST                 (255U)
+
+/* Status codes for scheduler APIs */
+typedef enum
+{
+    SCHED_STATUS_OK = 0,
+    SCHED_STATUS_INVALID_PARAM = 1,
+    SCHED_STATUS_FULL = 2
+} sched_status_t;
+
+typedef void (*sched_fn_t)(void *ctx);
+
+/* Per-task accounting since the last Sched_Reset_Stats() */
+typedef struct
+{
+    uint32_t runs;
+    uint32_t overruns;      /* periods skipped because the task ran late */
+    uint64_t total_us;      /* time spent inside the task */
+    uint32_t max_us;        /* longest single run */
+} sched_stats_t;
+
+/* Public API */
+/* Call after Timer_Init(): uses the 64-bit time base */
+void           Sched_Init(void);
+/* Register a task; period_ms == 0 makes it an event task (offset ignored).
+   The task id (registration order) is written to id if not NULL */
+sched_status_t Sched_Add(sched_fn_t fn, void *ctx, uint32_t period_ms,
+                         uint32_t offset_ms, uint8_t prio, uint8_t *id);
+/* Make event tasks runnable; safe from any ISR */
+void           Sched_Kick(void);
+/* Dispatch forever */
+void           Sched_Run(void);
+
+sched_status_t Sched_Get_Stats(uint8_t id, sched_stats_t *out);
+/* Share of time spent asleep, in 1/1000, since the last reset */
+uint16_t       Sched_Idle_Permille(void);
+void           Sched_Reset_Stats(void);
+
+#endif /* SCHED_H */
@@ -0,0 +1,191 @@
+/*
+ * Host test for elapsed-time stepping in anim.c and chime.c.
+ * - Runs a 1 ms main loop for 10 simulated minutes with the TIMER0 tick
+ *   events (LED1 350 ms, LED2 400 ms, buzzer 20 ms) posted into a 32-entry
+ *   ring that drops new events when full, like timer_evq.
+ * - Randomly stalls the loop for 0..2000 ms; events keep being posted (and
+ *   dropped) meanwhile. Event stamps get 0..50 us of ISR latency.
+ * - Restarts animations and chimes at random times so the phase is learned
+ *   again from whatever tick happens to survive.
+ * - After every loop pass checks:
+ *     anim:  the frame shown equals the ideal one (ticks since play mod count);
+ *     chime: the step is the ideal one, at most CHIME_TICK_MS behind.
+ *
+ * Build (host machine with GCC/Clang):
+ *   gcc -std=c99 -O2 -o sim_catchup Codes/sim_catchup.c
+ * Run:
+ *   ./sim_catchup     (exit code 0 = pass)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* Host stand-ins for the lamp framebuffer and the buzzer PWM */
+static uint8_t fb_value;
+void LampFB_Write(uint8_t index, uint8_t mask, uint8_t value)
+{
+    (void)index; (void)mask;
+    fb_value = value;
+}
+void PWM_Buzzer_Set(uint32_t period_ticks, uint32_t on_ticks) { (void)period_ticks; (void)on_ticks; }
+void PWM_Buzzer_Enable(uint8_t on) { (void)on; }
+/* No flasher: beat-locked chimes run on their own timeline */
+uint8_t  Flasher_Running(void) { return 0U; }
+uint64_t Flasher_Beat_Start_Us(uint64_t t_us) { return t_us; }
+
+/* NOTE: We include the C files directly to avoid linking hardware drivers. */
+#include "anim.c"
+#include "chime.c"
+
+#define SIM_MS           (600000UL)   /* 10 minutes of 1 ms passes */
+#define RING_SIZE        (32U)
+#define STALL_MAX_MS     (2000U)
+
+static const chime_step_t sim_finite_steps[] =
+{
+    { CHIME_TONE_HZ, 500U,  60U },
+    { 0U,              0U, 140U },
+    { CHIME_TONE_HZ, 500U,  20U },
+    { 0U,              0U,  80U }
+};
+static const chime_t sim_finite = { CHIME_STEPS(sim_finite_steps), 3U, 0U };
+
+static const anim_t  *const sim_anims[]  = { &Anim_Left_Fill, &Anim_Right_Fill, &Anim_Sweep };
+static const chime_t *const sim_chimes[] = { &Chime_Turn, &Chime_Seatbelt, &sim_finite };
+
+static evt_t    ring[RING_SIZE];
+static uint32_t ring_head, ring_tail, ring_dropped;
+
+static uint32_t rng_state = 20240611U;
+static uint32_t rng(void)
+{
+    rng_state = (rng_state * 1103515245U) + 12345U;
+    return rng_state >> 8;
+}
+
+static void isr_post(uint8_t id, uint64_t tick_us)
+{
+    if ((ring_head - ring_tail) >= RING_SIZE)
+    {
+        ring_dropped++;
+        return;
+    }
+    ring[ring_head % RING_SIZE].id      = id;
+    ring[ring_head % RING_SIZE].time_us = tick_us + (rng() % 51U);
+    ring_head++;
+}
+
+/* Ideal chime step at t_us after start: index, or 0xFF once finished */
+static uint8_t ideal_step(const chime_t *c, uint64_t t_us)
+{
+    uint32_t cycle = 0U, pos;
+    uint64_t ms = t_us / 1000U;
+    uint8_t  i;
+
+    for (i = 0U; i < c->count; i++) { cycle += c->steps[i].duration_ms; }
+    if ((c->loops != CHIME_LOOP_FOREVER) && (ms >= ((uint64_t)cycle * c->loops))) { return 0xFFU; }
+    pos = (uint32_t)(ms % cycle);
+    for (i = 0U; pos >= c->steps[i].duration_ms; i++) { pos -= c->steps[i].duration_ms; }
+    return i;
+}
+
+int main(void)
+{
+    anim_player_t  ap;
+    chime_player_t cp;
+    const anim_t  *a = sim_anims[0];
+    const chime_t *c = sim_chimes[0];
+    uint64_t play_us = 0U, start_us = 0U;
+    uint32_t stall_left = 0U, stalls = 0U, longest = 0U;
+    uint32_t anim_errors = 0U, chime_errors = 0U, checks = 0U;
+    uint32_t chime_lag_max = 0U;
+    uint32_t ms;
+
+    Anim_Init(&ap, 0U);
+    Anim_Play(&ap, a, 0U);
+    Chime_Player_Start(&cp, c, 0U);
+
+    for (ms = 1U; ms <= SIM_MS; ++ms)
+    {
+        uint64_t tick_us = (uint64_t)ms * 1000U;
+        uint64_t now_us  = tick_us + 500U;   /* main pass runs after the ISR */
+
+        /* TIMER0 ISR */
+        if ((ms % TIMER_LED1_PERIOD_MS) == 0U)   { isr_post((uint8_t)EVT_LED1_TICK, tick_us); }
+        if ((ms % TIMER_LED2_PERIOD_MS) == 0U)   { isr_post((uint8_t)EVT_LED2_TICK, tick_us); }
+        if ((ms % TIMER_BUZZER_PERIOD_MS) == 0U) { isr_post((uint8_t)EVT_BUZZER_TICK, tick_us); }
+
+        if (stall_left != 0U)
+        {
+            stall_left--;
+            continue;
+        }
+        if ((rng() % 400U) == 0U)
+        {
+            stall_left = rng() % (STALL_MAX_MS + 1U);
+            stalls++;
+            if (stall_left > longest) { longest = stall_left; }
+            continue;
+        }
+
+        /* Occasional restarts, as on a direction change or a new request */
+        if ((rng() % 7000U) == 0U)
+        {
+            a = sim_anims[rng() % 3U];
+            Anim_Stop(&ap);
+            Anim_Play(&ap, a, now_us);
+            play_us = now_us;
+        }
+        if ((rng() % 5000U) == 0U)
+        {
+            c = sim_chimes[rng() % 3U];
+            Chime_Player_Start(&cp, c, now_us);
+            start_us = now_us;
+        }
+
+        /* Main loop: drain, then show what is due now */
+        while (ring_tail != ring_head)
+        {
+            const evt_t *e = &ring[ring_tail % RING_SIZE];
+            Anim_On_Event(&ap, e);
+            if (e->id == (uint8_t)EVT_BUZZER_TICK)
+            {
+                (void)Chime_Player_Update(&cp, now_us);
+            }
+            ring_tail++;
+        }
+        Anim_Update(&ap, now_us);
+
+        /* Anim: ticks since play decide the frame exactly */
+        {
+            uint64_t step_us = (uint64_t)a->step_ms * 1000U;
+            uint64_t ticks   = (tick_us / step_us) - (play_us / step_us);
+            if (fb_value != a->frames[ticks % a->count]) { anim_errors++; }
+        }
+
+        /* Chime: find how far behind the ideal timeline the player is */
+        {
+            const chime_step_t *s   = Chime_Player_Step(&cp);
+            uint8_t             got = (s != NULL) ? (uint8_t)(s - c->steps) : 0xFFU;
+            uint32_t            lag;
+
+            for (lag = 0U; lag <= (CHIME_TICK_MS + 1U); ++lag)
+            {
+                uint64_t back = (uint64_t)lag * 1000U;
+                if ((now_us - back) < start_us) { break; }
+                if (ideal_step(c, now_us - back - start_us) == got) { break; }
+            }
+            if (((now_us - ((uint64_t)lag * 1000U)) >= start_us) && (lag > CHIME_TICK_MS)) { chime_errors++; }
+            if (lag > chime_lag_max) { chime_lag_max = lag; }
+        }
+        checks++;
+    }
+
+    printf("\nElapsed-time catch-up over %lu ms: %u stalls (longest %u ms), %u events dropped\n",
+           SIM_MS, stalls, longest, ring_dropped);
+    printf("anim : %u wrong frames in %u checks -> %s\n",
+           anim_errors, checks, (anim_errors == 0U) ? "PASS" : "FAIL");
+    printf("chime: %u steps more than %u ms late, worst lag %u ms -> %s\n",
+           chime_errors, CHIME_TICK_MS, chime_lag_max, (chime_errors == 0U) ? "PASS" : "FAIL");
+    return ((anim_errors == 0U) && (chime_errors == 0U)) ? 0 : 1;
+}
@@ -0,0 +1,352 @@
+/*
+ * Host test for the flash key/value store in flash_kv.c.
+ * - Maps the two store sectors at their target addresses (0x70000) and
+ *   puts a jump to a mock IAP at 0x1FFF1FF1, so flash_kv.c runs unchanged.
+ *   The mock enforces the flash rules: prepare before erase/program, and
+ *   a program may only turn erased bits to 0 (each page written once).
+ * - Starts from garbage flash, then runs 40 boots of 300 flushes with 1..4
+ *   random keys each, enough for two compactions per boot with no reboot
+ *   in between. On FULL the test calls Flash_KV_Maintain() and flushes
+ *   again, as Persist_Maintain() does.
+ * - Every fourth boot, power fails part-way through one IAP program: the
+ *   page is left with its first words written and one word half-written.
+ *   Every other time that program is the header page of a compaction.
+ * - One boot leaves the spare dirty after a compaction and flushes until
+ *   FULL, then maintains and flushes again.
+ * - Checks after every boot and flush:
+ *     values:  every key reads back its last flushed value; after a power
+ *              failure, keys of the torn flush hold the old or the new one;
+ *     flash:   no page is programmed twice without an erase;
+ *     compact: at least two compactions happened within one boot, and
+ *              FULL kept the values in RAM until the next flush.
+ *
+ * Build (Linux x86-64 host with GCC/Clang):
+ *   gcc -std=c99 -O2 -ICodes/vendor -o sim_flash_kv Codes/sim_flash_kv.c
+ * Run:
+ *   ./sim_flash_kv     (exit code 0 = pass)
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include <sys/mman.h>
+
+/* Host stand-ins for the target headers flash_kv.c includes; the vendor
+   header is only found on the include path, its guard keeps it out */
+#define __LPC17xx_H__
+#define CRITICAL_H
+#define CYCLES_H
+static uint32_t Critical_Enter(void) { return 0U; }
+static void     Critical_Exit(uint32_t primask) { (void)primask; }
+static uint32_t Cycles_Now(void) { return 0U; }
+
+/* NOTE: We include the C files directly to avoid linking hardware drivers. */
+#include "crc16.c"
+#include "flash_kv.c"
+
+#define SIM_BOOTS        (40U)
+#define SIM_FLUSHES      (300U)
+#define SIM_KEYS         (12U)        /* keys in use, of FLASH_KV_KEYS */
+#define SIM_TEAR_EVERY   (4U)         /* boots */
+#define SIM_FULL_BOOT    (17U)
+
+static uint32_t rng_state = 20240611U;
+static uint32_t rng(void)
+{
+    rng_state = (rng_state * 1103515245U) + 12345U;
+    return rng_state >> 8;
+}
+
+/* Mock IAP */
+static uint8_t  iap_prepared;
+static uint32_t iap_programs;
+static uint32_t iap_reprograms;
+static int32_t  iap_tear_in = -1;    /* program calls left before power fails */
+static uint8_t  iap_tear_header;     /* power fails on the next header page */
+static uint32_t iap_tears;
+static uint32_t iap_header_tears;
+static jmp_buf  power_fail;
+
+static void iap_mock(uint32_t *cmd, uint32_t *res)
+{
+    uint32_t *dst;
+    uint32_t  n;
+    uint32_t  i;
+
+    res[0] = FLASH_KV_IAP_SUCCESS;
+    if (cmd[0] == FLASH_KV_IAP_PREPARE)
+    {
+        iap_prepared = 1U;
+        return;
+    }
+    if (iap_prepared == 0U)
+    {
+        res[0] = 9U;   /* SECTOR_NOT_PREPARED_FOR_WRITE_OPERATION */
+        return;
+    }
+    iap_prepared = 0U;
+
+    if (cmd[0] == FLASH_KV_IAP_ERASE)
+    {
+        for (i = cmd[1]; i <= cmd[2]; i++)
+        {
+            memset((void *)(uintptr_t)(FLASH_KV_SECTOR_A_BASE + ((i - FLASH_KV_SECTOR_A) * FLASH_KV_SECTOR_BYTES)),
+                   0xFF, FLASH_KV_SECTOR_BYTES);
+        }
+        return;
+    }
+    if (cmd[0] == FLASH_KV_IAP_COPY)
+    {
+        /* The source is always the page buffer; its host address does
+           not fit the 32-bit command word */
+        dst = (uint32_t *)(uintptr_t)cmd[1];
+        n   = cmd[3] / 4U;
+        iap_programs++;
+        for (i = 0U; i < n; i++)
+        {
+            if ((dst[i] & flash_kv_page[i]) != flash_kv_page[i])
+            {
+                iap_reprograms++;
+            }
+        }
+        if ((iap_tear_header != 0U) && ((cmd[1] % FLASH_KV_SECTOR_BYTES) == 0U))
+        {
+            iap_tear_header = 0U;
+            iap_header_tears++;
+            iap_tear_in = 0;
+        }
+        if (iap_tear_in == 0)
+        {
+            iap_tear_in = -1;
+            iap_tears++;
+            n = rng() % FLASH_KV_PAGE_WORDS;
+            for (i = 0U; i < n; i++)
+            {
+                dst[i] &= flash_kv_page[i];
+            }
+            dst[n] &= flash_kv_page[n] | rng();   /* half-programmed word */
+            longjmp(power_fail, 1);
+        }
+        if (iap_tear_in > 0)
+        {
+            iap_tear_in--;
+        }
+        for (i = 0U; i < n; i++)
+        {
+            dst[i] &= flash_kv_page[i];
+        }
+        return;
+    }
+    res[0] = 1U;   /* INVALID_COMMAND */
+}
+
+/* What the application wrote (ram) and what has reached flash (flashed) */
+static uint32_t ram[SIM_KEYS];
+static uint32_t flashed[SIM_KEYS];
+static uint8_t  has_ram[SIM_KEYS];
+static uint8_t  has_flashed[SIM_KEYS];
+static uint8_t  torn;
+
+/* Results; static so they survive the longjmp of a power failure */
+static uint32_t boot;
+static uint32_t value_errors, flush_errors, fulls, full_checks;
+static uint32_t compactions, most_per_boot, erases;
+
+/* After Init: each key as last flushed, or old/new for a torn flush */
+static void check_boot(void)
+{
+    uint32_t v;
+    uint8_t  k;
+
+    for (k = 0U; k < SIM_KEYS; k++)
+    {
+        flash_kv_status_t st = Flash_KV_Get(k, &v);
+
+        if (st == FLASH_KV_STATUS_OK)
+        {
+            uint8_t as_old = ((has_flashed[k] != 0U) && (v == flashed[k])) ? 1U : 0U;
+            uint8_t as_new = ((torn != 0U) && (has_ram[k] != 0U) && (v == ram[k])) ? 1U : 0U;
+            if ((as_old == 0U) && (as_new == 0U))
+            {
+                value_errors++;
+            }
+            flashed[k] = v;
+        }
+        else if (has_flashed[k] != 0U)
+        {
+            value_errors++;
+        }
+        else
+        {
+            /* never flushed: not found is right */
+        }
+        has_flashed[k] = (st == FLASH_KV_STATUS_OK) ? 1U : 0U;
+        has_ram[k]     = has_flashed[k];
+        ram[k]         = flashed[k];
+    }
+    torn = 0U;
+}
+
+/* In RAM before a flush: every key reads back what was set */
+static void check_ram(void)
+{
+    uint32_t v;
+    uint8_t  k;
+
+    for (k = 0U; k < SIM_KEYS; k++)
+    {
+        if ((has_ram[k] != 0U) && ((Flash_KV_Get(k, &v) != FLASH_KV_STATUS_OK) || (v != ram[k])))
+        {
+            value_errors++;
+        }
+    }
+}
+
+static void set_random(void)
+{
+    uint32_t n = 1U + (rng() % 4U);
+
+    while (n-- != 0U)
+    {
+        uint8_t  k = (uint8_t)(rng() % SIM_KEYS);
+        uint32_t v = rng() ^ (rng() << 16);
+
+        (void)Flash_KV_Set(k, v);
+        ram[k]     = v;
+        has_ram[k] = 1U;
+    }
+}
+
+static void flushed_all(void)
+{
+    memcpy(flashed, ram, sizeof(flashed));
+    memcpy(has_flashed, has_ram, sizeof(has_flashed));
+}
+
+int main(void)
+{
+    void    *sectors;
+    void    *rom;
+    uint8_t *stub;
+    uint64_t entry = (uint64_t)(uintptr_t)iap_mock;
+    uint32_t f;
+    flash_kv_stats_t st;
+
+    sectors = mmap((void *)(uintptr_t)FLASH_KV_SECTOR_A_BASE, 2U * FLASH_KV_SECTOR_BYTES,
+                   PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    rom     = mmap((void *)(uintptr_t)(FLASH_KV_IAP_ENTRY & ~0xFFFUL), 0x1000U,
+                   PROT_READ | PROT_WRITE | PROT_EXEC, MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if ((sectors == MAP_FAILED) || (rom == MAP_FAILED))
+    {
+        perror("mmap");
+        return 2;
+    }
+    memset(sectors, 0x5A, 2U * FLASH_KV_SECTOR_BYTES);   /* never formatted */
+
+    /* movabs rax, iap_mock ; jmp rax (the Thumb bit lands on an odd address) */
+    stub = (uint8_t *)(uintptr_t)FLASH_KV_IAP_ENTRY;
+    stub[0] = 0x48U;
+    stub[1] = 0xB8U;
+    memcpy(&stub[2], &entry, sizeof(entry));
+    stub[10] = 0xFFU;
+    stub[11] = 0xE0U;
+
+    for (boot = 0U; boot < SIM_BOOTS; boot++)
+    {
+        if (setjmp(power_fail) != 0)
+        {
+            torn = 1U;
+            continue;   /* power lost: next boot */
+        }
+
+        if (Flash_KV_Init() != FLASH_KV_STATUS_OK)
+        {
+            flush_errors++;
+        }
+        check_boot();
+
+        /* Alternately anywhere, or on the header of the next compaction */
+        if ((boot % SIM_TEAR_EVERY) == (SIM_TEAR_EVERY - 1U))
+        {
+            if (((boot / SIM_TEAR_EVERY) % 2U) == 0U)
+            {
+                iap_tear_in = (int32_t)(rng() % SIM_FLUSHES);
+            }
+            else
+            {
+                iap_tear_header = 1U;
+            }
+        }
+
+        for (f = 0U; f < SIM_FLUSHES; f++)
+        {
+            flash_kv_status_t s;
+
+            set_random();
+            check_ram();
+            s = Flash_KV_Flush();
+            if (s == FLASH_KV_STATUS_FULL)
+            {
+                fulls++;
+                if (boot == SIM_FULL_BOOT)
+                {
+                    /* Held back: values stay in RAM over more refused flushes */
+                    uint32_t i;
+                    for (i = 0U; i < 5U; i++)
+                    {
+                        set_random();
+                        if (Flash_KV_Flush() != FLASH_KV_STATUS_FULL)
+                        {
+                            flush_errors++;
+                        }
+                        check_ram();
+                        full_checks++;
+                    }
+                }
+                if (Flash_KV_Maintain() != FLASH_KV_STATUS_OK)
+                {
+                    flush_errors++;
+                }
+                s = Flash_KV_Flush();
+            }
+            if (s != FLASH_KV_STATUS_OK)
+            {
+                flush_errors++;
+            }
+            else
+            {
+                flushed_all();
+            }
+
+            /* Normally the spare is erased right after a compaction, at the
+               next quiet point; on SIM_FULL_BOOT it is left until FULL */
+            if (boot != SIM_FULL_BOOT)
+            {
+                (void)Flash_KV_Maintain();
+            }
+        }
+
+        Flash_KV_Get_Stats(&st);
+        compactions += st.compactions;
+        erases      += st.erases;
+        if (st.compactions > most_per_boot)
+        {
+            most_per_boot = st.compactions;
+        }
+    }
+
+    printf("\nFlash K/V over %u boots: %u IAP programs, %u compactions (up to %u in one boot), %u erases\n",
+           SIM_BOOTS, iap_programs, compactions, most_per_boot, erases);
+    printf("power failures mid-program: %u (%u on a compaction header), FULL answers: %u (%u RAM checks while full)\n",
+           iap_tears, iap_header_tears, fulls, full_checks);
+    printf("values : %u wrong -> %s\n", value_errors, (value_errors == 0U) ? "PASS" : "FAIL");
+    printf("flash  : %u pages programmed twice, %u failed calls -> %s\n", iap_reprograms, flush_errors,
+           ((iap_reprograms == 0U) && (flush_errors == 0U)) ? "PASS" : "FAIL");
+    printf("compact: %s\n", ((most_per_boot >= 2U) && (full_checks != 0U) && (iap_header_tears != 0U)) ?
+           "PASS" : "FAIL");
+
+    return ((value_errors == 0U) && (iap_reprograms == 0U) && (flush_errors == 0U) &&
+            (most_per_boot >= 2U) && (full_checks != 0U) && (iap_header_tears != 0U)) ? 0 : 1;
+}
@@ -1,8 +1,11 @@
 /*
- * Simple simulation to demonstrate edge detection in Indicator().
- * - Stubs HC595_Load() to print the pattern and timestamp instead of driving hardware.
- * - Simulates TIMER0 toggling LED1_flag and LED2_flag at fixed intervals.
- * - Calls Indicator(direction) every 1 ms to show that steps advance only on edges.
+ * Simple simulation to demonstrate tick-event pacing in Indicator().
+ * - Stubs LampFB_Write() to print the pattern and timestamp instead of driving hardware.
+ * - Simulates TIMER0 posting EVT_LED1_TICK and EVT_LED2_TICK at their real periods.
+ * - Calls Indicator(direction) every 1 ms to show that steps follow the beat
+ *   started with the pattern (the flasher shared with the tick sound), not the loop.
+ * - Finally stalls the loop for several periods, dropping every tick meanwhile,
+ *   to show it resumes on the frame that is due rather than where it stopped.
  *
  * Build (host machine with GCC/Clang):
  *   gcc -std=c99 -O2 -o sim Codes/sim_indicator_edge_demo.c
@@ -14,13 +17,10 @@
 #include <stdio.h>
 #include <string.h>
 
-/* Provide the flags expected by implement_indicator.c */
-volatile uint8_t LED1_flag = 0U; /* toggles every 400 ms in this sim */
-volatile uint8_t LED2_flag = 0U; /* toggles every 100 ms in this sim */
-
-/* Mock the hardware loader used by implement_indicator.c */
-void HC595_Load(uint8_t value)
+/* Mock the lamp framebuffer used by implement_indicator.c */
+void LampFB_Write(uint8_t index, uint8_t mask, uint8_t value)
 {
+    (void)index; (void)mask;
     /* Print as 8-bit binary for clarity */
     char bits[9];
     for (int i = 7; i >= 0; --i) { bits[7 - i] = (char)('0' + ((value >> i) & 1U)); }
@@ -31,8 +31,18 @@ void HC595_Load(uint8_t value)
     printf("t=%4u ms  pattern=%s (0x%02X)\n", __sim_get_time(), bits, value);
 }
 
-/* Pull in the real logic under test. This file expects LED1_flag/LED2_flag and HC595_Load(). */
-/* NOTE: We include the C file directly to avoid linking hardware drivers. */
+/* Stand-in for flasher.c: the beat only matters to the tick sound here */
+#include "flasher.h"
+flasher_status_t Flasher_Start(uint16_t period_ms, uint64_t now_us)
+{
+    (void)period_ms; (void)now_us;
+    return FLASHER_STATUS_OK;
+}
+void Flasher_Stop(void) { }
+
+/* Pull in the real logic under test. These files expect LampFB_Write(). */
+/* NOTE: We include the C files directly to avoid linking hardware drivers. */
+#include "anim.c"
 #include "implement_indicator.c"
 
 /* Simple time keeper for printing */
@@ -40,15 +50,25 @@ static uint32_t g_now_ms = 0U;
 void __sim_set_time(uint32_t t) { g_now_ms = t; }
 uint32_t __sim_get_time(void) { return g_now_ms; }
 
+/* Stand-in for systime.c */
+uint64_t time_now_us(void) { return (uint64_t)g_now_ms * 1000U; }
+
+/* Timer events at fixed periods: LED1 every 350 ms, LED2 every 400 ms */
+static void sim_timer_events(void)
+{
+    evt_t e = { 0U, EVT_NONE, 0U };
+    e.time_us = (uint64_t)g_now_ms * 1000U;
+    if ((g_now_ms % TIMER_LED1_PERIOD_MS) == 0U) { e.id = EVT_LED1_TICK; Indicator_On_Event(&e); }
+    if ((g_now_ms % TIMER_LED2_PERIOD_MS) == 0U) { e.id = EVT_LED2_TICK; Indicator_On_Event(&e); }
+}
+
 static void step_time_ms(uint32_t dt)
 {
     /* Advance simulated time in 1 ms increments and run the app loop */
     for (uint32_t i = 0; i < dt; ++i)
     {
         g_now_ms++;
-        /* Toggle flags at fixed periods: LED1 every 400 ms, LED2 every 100 ms */
-        if ((g_now_ms % 400U) == 0U) { LED1_flag ^= 1U; }
-        if ((g_now_ms % 100U) == 0U) { LED2_flag ^= 1U; }
+        sim_timer_events();
 
         /* Call the non-blocking Indicator every 1 ms like a main loop would */
         Indicator(1U); /* Try direction 1 first; change below for other demos */
@@ -57,52 +77,62 @@ static void step_time_ms(uint32_t dt)
 
 int main(void)
 {
-    printf("\nDemo 1: Direction=1 (lower nibble MSB->LSB), paced by LED1_flag edges (~400 ms)\n");
-    g_now_ms = 0U; LED1_flag = 0U; LED2_flag = 0U;
+    printf("\nDemo 1: Direction=1 (lower nibble MSB->LSB), one step per 350 ms beat\n");
+    g_now_ms = 0U;
     /* Run for ~4 seconds */
     step_time_ms(4000U);
 
-    printf("\nDemo 2: Direction=2 (upper nibble LSB->MSB), paced by LED2_flag edges (~100 ms)\n");
+    printf("\nDemo 2: Direction=2 (upper nibble LSB->MSB), one step per 400 ms beat\n");
     /* Reset state inside Indicator by switching direction in-place */
     for (int i = 0; i < 10; ++i)
     {
         /* Switch to direction 2 for this phase */
         g_now_ms++;
-        if ((g_now_ms % 400U) == 0U) { LED1_flag ^= 1U; }
-        if ((g_now_ms % 100U) == 0U) { LED2_flag ^= 1U; }
+        sim_timer_events();
         Indicator(2U);
     }
-    /* Continue running dir=2 for ~1.2 s */
-    for (uint32_t i = 0; i < 1200U; ++i)
+    /* Continue running dir=2 for ~2.4 s */
+    for (uint32_t i = 0; i < 2400U; ++i)
     {
         g_now_ms++;
-        if ((g_now_ms % 400U) == 0U) { LED1_flag ^= 1U; }
-        if ((g_now_ms % 100U) == 0U) { LED2_flag ^= 1U; }
+        sim_timer_events();
         Indicator(2U);
     }
 
-    printf("\nDemo 3: Direction=3 (center-out), paced by LED1_flag edges (~400 ms)\n");
+    printf("\nDemo 3: Direction=3 (center-out), one step per 350 ms beat\n");
     /* Small transition calls to reset state to dir=3 */
     for (int i = 0; i < 10; ++i)
     {
         g_now_ms++;
-        if ((g_now_ms % 400U) == 0U) { LED1_flag ^= 1U; }
-        if ((g_now_ms % 100U) == 0U) { LED2_flag ^= 1U; }
+        sim_timer_events();
         Indicator(3U);
     }
     /* Run ~2.5 seconds */
     for (uint32_t i = 0; i < 2500U; ++i)
     {
         g_now_ms++;
-        if ((g_now_ms % 400U) == 0U) { LED1_flag ^= 1U; }
-        if ((g_now_ms % 100U) == 0U) { LED2_flag ^= 1U; }
+        sim_timer_events();
+        Indicator(3U);
+    }
+
+    printf("\nDemo 4: Direction=3, main loop stalled for 1.3 s with every tick lost, then resumes\n");
+    for (uint32_t i = 0; i < 1300U; ++i)
+    {
+        g_now_ms++;           /* no events delivered: worst case, ring overflowed */
+    }
+    Indicator(3U);            /* jumps straight to the frame due now */
+    for (uint32_t i = 0; i < 800U; ++i)
+    {
+        g_now_ms++;
+        sim_timer_events();
         Indicator(3U);
     }
 
     printf("\nNotes:\n");
-    printf("- Even though Indicator() runs every 1 ms, it only steps when LEDx_flag toggles.\n");
-    printf("- That edge (curr != prev) occurs at the configured periods (400/100 ms here).\n");
-    printf("- Therefore the visible step-to-step delay is set by the timer, not by the loop speed.\n");
+    printf("- Even though Indicator() runs every 1 ms, it only steps on the beat.\n");
+    printf("- The beat starts with the pattern and runs at its period (350/400 ms).\n");
+    printf("- The frame shown is computed from elapsed time, so a stall costs no phase.\n");
+    printf("- Therefore the visible step-to-step delay is set by the beat, not by the loop speed.\n");
     return 0;
 }
 
@@ -0,0 +1,104 @@
+/*
+ * Host test for timebase.c: long-run drift of timer periods.
+ * - Models a periodic deadline advanced by Timebase_Step_Next() every period,
+ *   exactly as swtimer.c re-arms periodic timers on the free-running TIMER0
+ *   (a 1 ms period is also what a reset-on-match tick of MR0 + 1 counts uses).
+ * - Runs 24 simulated hours for several count rates, including ones that are
+ *   not a multiple of 1 kHz, and checks the accumulated timer counts never
+ *   differ from ideal time by one count or more.
+ * - Also checks that arbitrary ms periods (350/400/20 ms) stay exact and
+ *   prints the drift of the old fixed MR0 = 100 setting for comparison.
+ *
+ * Build (host machine with GCC/Clang):
+ *   gcc -std=c99 -O2 -o sim_timebase Codes/sim_timebase_drift.c
+ * Run:
+ *   ./sim_timebase     (exit code 0 = pass)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* NOTE: We include the C file directly to avoid linking hardware drivers. */
+#include "timebase.c"
+
+#define SIM_HOURS        (24ULL)
+#define SIM_MS           (SIM_HOURS * 3600ULL * 1000ULL)
+
+static int check_tick(uint32_t tick_hz)
+{
+    timebase_step_t step;
+    uint64_t counts = 0U;
+    uint64_t ms;
+    int64_t  worst = 0;   /* worst |error| in 1/1000 count */
+
+    if (Timebase_Step_Init(&step, 1U, tick_hz) != TIMEBASE_STATUS_OK)
+    {
+        printf("tick %9u Hz: init failed\n", tick_hz);
+        return 1;
+    }
+
+    for (ms = 1U; ms <= SIM_MS; ++ms)
+    {
+        uint32_t mr0 = Timebase_Step_Next(&step) - 1U;   /* value the ISR writes */
+        counts += (uint64_t)mr0 + 1U;                    /* counts 0..MR0 */
+
+        {
+            int64_t err = (int64_t)(counts * 1000ULL) - (int64_t)(ms * (uint64_t)tick_hz);
+            if (err < 0) { err = -err; }
+            if (err > worst) { worst = err; }
+        }
+    }
+
+    printf("tick %9u Hz: %llu h, worst phase error %.3f counts, end drift %.3f us -> %s\n",
+           tick_hz, SIM_HOURS, (double)worst / 1000.0,
+           ((double)counts * 1e6 / (double)tick_hz) - ((double)SIM_MS * 1e3),
+           (worst < 1000) ? "PASS" : "FAIL");
+    return (worst < 1000) ? 0 : 1;
+}
+
+static int check_period(uint32_t period_ms, uint32_t tick_hz)
+{
+    timebase_step_t step;
+    uint64_t counts = 0U;
+    uint64_t n;
+    uint64_t periods = SIM_MS / period_ms;
+    int64_t  err;
+
+    (void)Timebase_Step_Init(&step, period_ms, tick_hz);
+    for (n = 0U; n < periods; ++n)
+    {
+        counts += Timebase_Step_Next(&step);
+    }
+    err = (int64_t)(counts * 1000ULL) - (int64_t)(periods * period_ms * (uint64_t)tick_hz);
+    if (err < 0) { err = -err; }
+
+    printf("period %4u ms @ %9u Hz: %llu periods, error %.3f counts -> %s\n",
+           period_ms, tick_hz, (unsigned long long)periods, (double)err / 1000.0,
+           (err < 1000) ? "PASS" : "FAIL");
+    return (err < 1000) ? 0 : 1;
+}
+
+int main(void)
+{
+    static const uint32_t ticks[] = { 100000U, 1000000U, 390625U, 32768U, 6250U };
+    int fails = 0;
+    unsigned i;
+
+    printf("\nMillisecond tick, %llu simulated hours\n", SIM_HOURS);
+    for (i = 0U; i < (sizeof(ticks) / sizeof(ticks[0])); ++i)
+    {
+        fails += check_tick(ticks[i]);
+    }
+
+    printf("\nArbitrary periods\n");
+    fails += check_period(350U, 100000U);
+    fails += check_period(400U, 390625U);
+    fails += check_period(20U, 32768U);
+    fails += check_period(333U, 6250U);
+
+    printf("\nReference: old fixed MR0 = 100 at 100 kHz counts 101 per tick -> %.1f s late after %llu h\n",
+           (double)SIM_MS * 0.01 / 1000.0, SIM_HOURS);
+
+    printf("\n%s\n", (fails == 0) ? "ALL PASS" : "FAILURES");
+    return (fails == 0) ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+/*
+ * Host benchmark for twheel.c: TIMER0 ISR cost versus number of active timers.
+ * - Stubs the swtimer clock and the critical section so the wheel runs on the host.
+ * - Checks that TWheel_Start() before TWheel_Init() is refused.
+ * - Starts 10, 100 and 1000 periodic timers, random phase, and times
+ *   TWheel_Tick() over 40 simulated minutes of 1 ms ticks:
+ *     short: periods 20..2000 ms (levels 0 and 1);
+ *     long:  half of them 20 s..TWHEEL_MAX_DELAY_TICKS (level 2).
+ * - Checks every expiry lands on exactly the expected tick, and that no
+ *   slot was left to move at its deadline (twheel_late), i.e. no tick ever
+ *   moved more than TWHEEL_CASCADE_STEP timers per level.
+ * - Runs the long mix once more through the tickless clock: TIMER0 is only
+ *   advanced to the deadline the wheel arms, with 0..50 us of ISR latency
+ *   and occasional stalls of up to 150 ms, and counts the wakeups.
+ * - For comparison, times the old scheme: one counter increment + compare per
+ *   timer per tick inside the ISR.
+ *
+ * Build (host machine with GCC/Clang):
+ *   gcc -std=c99 -O2 -o sim_twheel Codes/sim_twheel_bench.c
+ * Run:
+ *   ./sim_twheel     (exit code 0 = pass)
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/* Host stand-ins for the target critical section and swtimer clock */
+#define CRITICAL_H
+static uint32_t Critical_Enter(void) { return 0U; }
+static void Critical_Exit(uint32_t primask) { (void)primask; }
+
+#define TWHEEL_POOL_SIZE (1024U)
+
+/* NOTE: We include the C file directly to avoid linking hardware drivers. */
+#include "twheel.c"
+
+static uint32_t     sim_tc;          /* TIMER0 count, 1 us */
+static uint32_t     clock_deadline;
+static swtimer_cb_t clock_cb;
+
+swtimer_status_t SwTimer_Start_At(swtimer_t *t, uint32_t deadline, swtimer_cb_t cb, void *ctx)
+{
+    (void)ctx;
+    t->active      = 1U;
+    clock_deadline = deadline;
+    clock_cb       = cb;
+    return SWTIMER_STATUS_OK;
+}
+
+void     SwTimer_Stop(swtimer_t *t) { t->active = 0U; }
+uint32_t SwTimer_Now(void) { return sim_tc; }
+
+#define SIM_TICKS        (2400000UL)   /* 40 minutes of 1 ms ticks */
+#define LEGACY_TICKS     (600000UL)
+#define MAX_TIMERS       (1000U)
+#define LONG_MIN_MS      (20000U)
+
+typedef struct
+{
+    uint32_t expected;
+    uint32_t period;
+} sim_timer_t;
+
+static sim_timer_t sims[MAX_TIMERS];
+static uint32_t    errors;
+static uint64_t    fired;
+
+static void on_expire(void *ctx)
+{
+    sim_timer_t *s = (sim_timer_t *)ctx;
+    if (twheel_now != s->expected) { errors++; }
+    s->expected += s->period;
+    fired++;
+}
+
+static uint32_t rng_state = 12345U;
+static uint32_t rng(void)
+{
+    rng_state = (rng_state * 1103515245U) + 12345U;
+    return rng_state >> 8;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/* Fresh wheel with n timers; with long_mix every other one is level 2 */
+static void start_timers(uint32_t n, uint8_t long_mix)
+{
+    uint32_t i;
+
+    TWheel_Init();
+    errors = 0U;
+    fired  = 0U;
+    sim_tc = 0U;
+    for (i = 0U; i < n; ++i)
+    {
+        uint32_t period = ((long_mix != 0U) && ((i & 1U) != 0U)) ?
+                          (LONG_MIN_MS + (rng() % (TWHEEL_MAX_DELAY_TICKS - LONG_MIN_MS + 1U))) :
+                          (20U + (rng() % 1981U));
+        uint32_t first  = 1U + (rng() % period);
+        sims[i].period   = period;
+        sims[i].expected = first;
+        if (TWheel_Start(first, period, on_expire, &sims[i]) == TWHEEL_INVALID_HANDLE) { errors++; }
+    }
+}
+
+static uint32_t bench_wheel(uint32_t n, uint8_t long_mix)
+{
+    uint64_t total = 0U, worst = 0U, idle_total = 0U, idle_ticks = 0U;
+    uint32_t tick;
+
+    start_timers(n, long_mix);
+    for (tick = 1U; tick <= SIM_TICKS; ++tick)
+    {
+        uint64_t fired_before = fired, t0, dt;
+
+        sim_tc += TWHEEL_TC_PER_TICK;
+        t0 = now_ns();
+        TWheel_Tick();
+        dt = now_ns() - t0;
+
+        total += dt;
+        if (dt > worst) { worst = dt; }
+        if (fired == fired_before) { idle_total += dt; idle_ticks++; }
+    }
+
+    printf("wheel  %4u timers %-5s: %6.1f ns/tick avg, %6.1f ns/tick without expiry, "
+           "worst %6llu ns, %8llu expiries, %u misses, %u late moves -> %s\n",
+           n, (long_mix != 0U) ? "long" : "short", (double)total / SIM_TICKS,
+           (idle_ticks != 0U) ? (double)idle_total / (double)idle_ticks : 0.0,
+           (unsigned long long)worst, (unsigned long long)fired, errors, twheel_late,
+           ((errors == 0U) && (twheel_late == 0U)) ? "PASS" : "FAIL");
+    return errors + twheel_late;
+}
+
+/* The same timers clocked the way the target does it */
+static uint32_t bench_tickless(uint32_t n)
+{
+    uint32_t wakeups = 0U, stalls = 0U, behind = 0U;
+
+    start_timers(n, 1U);
+    while (sim_tc < (SIM_TICKS * TWHEEL_TC_PER_TICK))
+    {
+        uint32_t latency = rng() % 51U;
+
+        if ((rng() % 2000U) == 0U)
+        {
+            latency += rng() % 150001U;   /* interrupts masked for a while */
+            stalls++;
+        }
+        if ((int32_t)(clock_deadline + latency - sim_tc) > 0)
+        {
+            sim_tc = clock_deadline + latency;
+        }
+        clock_cb(NULL);
+        wakeups++;
+        if (twheel_now != (sim_tc / TWHEEL_TC_PER_TICK)) { behind++; }
+    }
+
+    printf("clock  %4u timers long : %8u wakeups (%.1f per s, %u stalls), %8llu expiries, "
+           "%u misses, %u late moves, %u times behind -> %s\n",
+           n, wakeups, (double)wakeups * 1000.0 / SIM_TICKS, stalls, (unsigned long long)fired,
+           errors, twheel_late, behind, ((errors == 0U) && (twheel_late == 0U) && (behind == 0U)) ? "PASS" : "FAIL");
+    return errors + twheel_late + behind;
+}
+
+/* Old TIMER0_IRQHandler shape: every counter bumped and compared every tick */
+static volatile uint16_t legacy_counter[MAX_TIMERS];
+static volatile uint8_t  legacy_flag[MAX_TIMERS];
+
+static void bench_legacy(uint32_t n)
+{
+    uint64_t t0, total;
+    uint32_t tick, i;
+
+    t0 = now_ns();
+    for (tick = 0U; tick < LEGACY_TICKS; ++tick)
+    {
+        for (i = 0U; i < n; ++i)
+        {
+            legacy_counter[i]++;
+            if (legacy_counter[i] >= (sims[i].period & 0xFFFFU))
+            {
+                legacy_flag[i] ^= 1U;
+                legacy_counter[i] = 0U;
+            }
+        }
+    }
+    total = now_ns() - t0;
+    printf("legacy %4u timers      : %6.1f ns/tick avg\n", n, (double)total / LEGACY_TICKS);
+}
+
+int main(void)
+{
+    static const uint32_t counts[] = { 10U, 100U, 1000U };
+    uint32_t fails = 0U;
+    unsigned k;
+
+    /* Zeroed list heads are not empty lists: must be refused */
+    if (TWheel_Start(10U, 10U, on_expire, &sims[0]) != TWHEEL_INVALID_HANDLE)
+    {
+        printf("TWheel_Start() before TWheel_Init() accepted -> FAIL\n");
+        fails++;
+    }
+
+    printf("\nTWheel_Tick() cost over %lu ticks (host timing, relative scale only)\n", SIM_TICKS);
+    for (k = 0U; k < 3U; ++k)
+    {
+        fails += bench_wheel(counts[k], 0U);
+        fails += bench_wheel(counts[k], 1U);
+        bench_legacy(counts[k]);
+    }
+    printf("\n");
+    for (k = 0U; k < 3U; ++k)
+    {
+        fails += bench_tickless(counts[k]);
+    }
+
+    printf("\nNotes:\n");
+    printf("- 'without expiry' is the bookkeeping cost per tick, cascade steps included; it is\n");
+    printf("  bounded by 2 x TWHEEL_CASCADE_STEP moves (0 late moves), level 2 or not.\n");
+    printf("- 'worst' is dominated by host preemption, not by the wheel.\n");
+    printf("- Average cost grows only with the number of timers that actually fire in a tick.\n");
+    printf("- The legacy counter scan grows linearly with every timer, firing or not.\n");
+    printf("- The tickless clock only wakes for ticks that fire or move timers, and once a round.\n");
+    printf("\n%s\n", (fails == 0U) ? "ALL PASS" : "FAILURES");
+    return (fails == 0U) ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+/*
+ * Host test for the fixed-point warning controller in warning.c.
+ * - Runs Warning_Tick() and the float pseudocode (pseudocode_warning.c)
+ *   side by side on 5 ms ticks for 24 simulated hours of fuel traces:
+ *   slow drain and refill through the thresholds, steps, slosh noise of
+ *   up to +/-8 %, sensor spikes and out-of-range readings.
+ * - The reference runs in double; the pseudocode's single float is run
+ *   too, to show how far it strays itself.
+ * - Checks:
+ *     filter: |fixed - double| <= WARNING_FUEL_TOL_Q16 on every tick;
+ *     lamps:  low-fuel latch equal to the reference on every tick, except
+ *             while the reference is within the tolerance of a threshold;
+ *             seatbelt and service lamps always equal.
+ * - The cycle cost can only be measured on the target: Test.c publishes
+ *   the worst Warning_Tick() cost as warning_tick_cycles_max.
+ *
+ * Build (host machine with GCC/Clang):
+ *   gcc -std=c99 -O2 -o sim_warning Codes/sim_warning.c
+ * Run:
+ *   ./sim_warning     (exit code 0 = pass)
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* NOTE: We include the C file directly to avoid linking hardware drivers. */
+#include "warning.c"
+
+#define SIM_TICKS        (24UL * 3600UL * 1000UL / WARNING_TICK_MS)
+#define Q16_TO_PCT(q)    ((double)(q) / 65536.0)
+
+/* Float reference, as in the pseudocode */
+typedef struct
+{
+    double filt;
+    int    latched;
+} ref_t;
+
+static void ref_tick(ref_t *r, double fuel_pct, double alpha)
+{
+    r->filt = r->filt + alpha * (fuel_pct - r->filt);
+    if (!r->latched)
+    {
+        if (r->filt <= 15.0) { r->latched = 1; }
+    }
+    else
+    {
+        if (r->filt >= 18.0) { r->latched = 0; }
+    }
+}
+
+static float ref_filt_f = 100.0f;
+static void ref_tick_float(float fuel_pct)
+{
+    ref_filt_f = ref_filt_f + 0.02f * (fuel_pct - ref_filt_f);
+}
+
+static uint32_t rng_state = 20240612U;
+static uint32_t rng(void)
+{
+    rng_state = (rng_state * 1103515245U) + 12345U;
+    return rng_state >> 8;
+}
+
+/* Raw sensor reading at tick n, in Q16 percent (may be out of range) */
+static uint32_t fuel_trace(void)
+{
+    static int32_t level = 40 << 16;     /* true level */
+    static int32_t rate  = -20;          /* Q16 percent per tick */
+    int32_t raw;
+
+    if ((rng() % 200000U) == 0U) { rate = -rate; }           /* refuel / drive */
+    if ((rng() % 500000U) == 0U) { level = (int32_t)(rng() % (101U << 16)); }  /* step */
+    level += rate;
+    if (level < 0)         { level = 0;         rate = 20 + (int32_t)(rng() % 200U); }
+    if (level > (100 << 16)) { level = 100 << 16; rate = -20 - (int32_t)(rng() % 200U); }
+
+    raw = level + (int32_t)(rng() % (16U << 16)) - (8 << 16);  /* slosh */
+    if ((rng() % 5000U) == 0U) { raw = (int32_t)(rng() % (120U << 16)); } /* spike */
+    if (raw < 0) { raw = 0; }
+    return (uint32_t)raw;
+}
+
+int main(void)
+{
+    ref_t    ref = { 100.0, 0 };
+    double   tol = Q16_TO_PCT(WARNING_FUEL_TOL_Q16);
+    double   alpha = 0.02;
+    double   err_max = 0.0, err_f_max = 0.0;
+    uint32_t lamp_errors = 0U, near_threshold = 0U, on_edges = 0U;
+    uint32_t other_errors = 0U;
+    uint8_t  prev = 0U;
+    uint32_t n;
+
+    Warning_Init();
+
+    for (n = 0U; n < SIM_TICKS; n++)
+    {
+        warning_in_t in;
+        uint32_t     raw = fuel_trace();
+        double       raw_pct = Q16_TO_PCT((raw > WARNING_FUEL_FULL_Q16) ? WARNING_FUEL_FULL_Q16 : raw);
+        double       err;
+        uint8_t      lamps;
+
+        in.seatbelt_buckled = (uint8_t)((n / 3000U) & 1U);
+        in.service_due      = (uint8_t)((n / 7000U) & 1U);
+        in.fuel_pct_q16     = raw;
+        lamps = Warning_Tick(&in);
+        ref_tick(&ref, raw_pct, alpha);
+        ref_tick_float((float)raw_pct);
+
+        err = Q16_TO_PCT(Warning_Fuel_Q16()) - ref.filt;
+        if (err < 0.0) { err = -err; }
+        if (err > err_max) { err_max = err; }
+        err = (double)ref_filt_f - ref.filt;
+        if (err < 0.0) { err = -err; }
+        if (err > err_f_max) { err_f_max = err; }
+
+        if ((((lamps & WARNING_LAMP_LOW_FUEL) != 0U) ? 1 : 0) != ref.latched)
+        {
+            double d15 = ref.filt - 15.0, d18 = ref.filt - 18.0;
+            if (((d15 < tol) && (d15 > -tol)) || ((d18 < tol) && (d18 > -tol))) { near_threshold++; }
+            else                                                               { lamp_errors++; }
+            /* Re-sync so one near-threshold decision is not counted again */
+            ref.latched = ((lamps & WARNING_LAMP_LOW_FUEL) != 0U) ? 1 : 0;
+        }
+        if (((lamps & WARNING_LAMP_SEATBELT) != 0U) != (in.seatbelt_buckled == 0U)) { other_errors++; }
+        if (((lamps & WARNING_LAMP_SERVICE) != 0U)  != (in.service_due != 0U))      { other_errors++; }
+        if (((lamps & WARNING_LAMP_LOW_FUEL) != 0U) && ((prev & WARNING_LAMP_LOW_FUEL) == 0U)) { on_edges++; }
+        prev = lamps;
+    }
+
+    printf("\nWarning controller over %lu ticks (%lu h), %u low-fuel turn-ons\n",
+           SIM_TICKS, SIM_TICKS * WARNING_TICK_MS / 3600000UL, on_edges);
+    printf("filter: max |Q16 - double| = %.6f %% (tolerance %.6f %%, float32 pseudocode strays %.6f %%) -> %s\n",
+           err_max, tol, err_f_max, (err_max <= tol) ? "PASS" : "FAIL");
+    printf("lamps : %u low-fuel mismatches, %u within tolerance of a threshold, %u other -> %s\n",
+           lamp_errors, near_threshold, other_errors,
+           ((lamp_errors == 0U) && (other_errors == 0U)) ? "PASS" : "FAIL");
+    return ((err_max <= tol) && (lamp_errors == 0U) && (other_errors == 0U)) ? 0 : 1;
+}
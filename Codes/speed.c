@@ -0,0 +1,235 @@
+/*
+ * File: speed.c
+ * Purpose: Capture timestamp rings and the batched frequency pass.
+ * Notes: Each ring has one producer (the TIMER2 ISR, which only advances
+ *        head) and one consumer (Speed_Update, which only advances tail),
+ *        so neither side masks interrupts. Timestamps are 32-bit TIMER2
+ *        counts; differences are taken modulo 2^32, valid for periods up to
+ *        71 minutes, far beyond SPEED_TIMEOUT_MS.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "speed.h"
+
+#define SPEED_TIMEOUT_US   ((uint32_t)SPEED_TIMEOUT_MS * 1000U)
+#define SPEED_MHZ_Q16      ((uint64_t)SPEED_TIMER_HZ << 16)
+
+typedef struct
+{
+    uint32_t          ring[SPEED_RING];
+    volatile uint32_t head;       /* ISR */
+    volatile uint32_t tail;       /* Speed_Update */
+    uint32_t          last_edge;
+    uint8_t           have_edge;
+    uint32_t          hist[SPEED_MEDIAN_N];
+    uint8_t           hist_n;
+    uint8_t           hist_pos;
+    uint32_t          freq_q16;
+    speed_stats_t     stats;
+} speed_chan_t;
+
+static speed_chan_t speed_chan[SPEED_CH_COUNT];
+
+void Speed_Init(void)
+{
+    uint8_t c;
+
+    for (c = 0U; c < (uint8_t)SPEED_CH_COUNT; c++)
+    {
+        speed_chan[c].head           = 0U;
+        speed_chan[c].tail           = 0U;
+        speed_chan[c].have_edge      = 0U;
+        speed_chan[c].hist_n         = 0U;
+        speed_chan[c].hist_pos       = 0U;
+        speed_chan[c].freq_q16       = 0U;
+        speed_chan[c].stats.pulses   = 0U;
+        speed_chan[c].stats.glitches = 0U;
+        speed_chan[c].stats.overruns = 0U;
+    }
+
+    /* 1) Power, clock from the plan, capture pins */
+    LPC_SC->PCONP    |= PCONP_PCTIM2_MASK;
+    LPC_SC->PCLKSEL1 &= ~PCLKSEL1_PCLK_TIMER2_MASK;
+    LPC_SC->PCLKSEL1 |=  PCLKSEL1_PCLK_TIMER2_PLAN;
+    LPC_PINCON->PINSEL0 = (LPC_PINCON->PINSEL0 & ~PINSEL0_SPEED_MASK) | PINSEL0_SPEED_FUNC;
+
+    /* 2) Free-running 1 MHz timer, capture + interrupt on rising edges */
+    LPC_TIM2->TCR  = 0x02UL;           /* reset */
+    LPC_TIM2->CTCR = 0UL;              /* timer mode */
+    LPC_TIM2->PR   = SPEED_TIMER_PR;
+    LPC_TIM2->MCR  = 0UL;
+    LPC_TIM2->CCR  = SPEED_CCR_CAP0RE_CAP0I | SPEED_CCR_CAP1RE_CAP1I;
+    LPC_TIM2->IR   = 0x3FUL;
+    LPC_TIM2->TCR  = 0x01UL;           /* run */
+
+    NVIC_EnableIRQ(TIMER2_IRQn);
+}
+
+static void speed_capture(speed_chan_t *ch, uint32_t t)
+{
+    uint32_t head = ch->head;
+
+    if ((head - ch->tail) >= SPEED_RING)
+    {
+        ch->stats.overruns++;
+        return;
+    }
+    ch->ring[head % SPEED_RING] = t;
+    __DMB(); /* slot contents before the index that publishes it */
+    ch->head = head + 1U;
+}
+
+/* Capture ISR: timestamps only */
+void TIMER2_IRQHandler(void)
+{
+    uint32_t ir = LPC_TIM2->IR & (SPEED_IR_CR0 | SPEED_IR_CR1);
+
+    LPC_TIM2->IR = ir;
+    if ((ir & SPEED_IR_CR0) != 0UL)
+    {
+        speed_capture(&speed_chan[SPEED_CH_VEHICLE], LPC_TIM2->CR0);
+    }
+    if ((ir & SPEED_IR_CR1) != 0UL)
+    {
+        speed_capture(&speed_chan[SPEED_CH_ENGINE], LPC_TIM2->CR1);
+    }
+}
+
+/* Median of the period history (insertion sort of a copy, n <= 5) */
+static uint32_t speed_median(const speed_chan_t *ch)
+{
+    uint32_t s[SPEED_MEDIAN_N];
+    uint8_t  i;
+    uint8_t  j;
+
+    for (i = 0U; i < ch->hist_n; i++)
+    {
+        uint32_t v = ch->hist[i];
+        for (j = i; (j > 0U) && (s[j - 1U] > v); j--)
+        {
+            s[j] = s[j - 1U];
+        }
+        s[j] = v;
+    }
+    return s[ch->hist_n / 2U];
+}
+
+static void speed_pass(speed_chan_t *ch)
+{
+    uint32_t med   = (ch->hist_n != 0U) ? speed_median(ch) : 0U;
+    uint32_t count = 0U;
+    uint32_t first = 0U;
+    uint32_t head  = ch->head;
+    uint32_t now   = LPC_TIM2->TC;   /* after head: no drained edge is later */
+    uint32_t since;
+
+    __DMB(); /* index before the slot contents it covers */
+    while (ch->tail != head)
+    {
+        uint32_t t = ch->ring[ch->tail % SPEED_RING];
+        uint32_t p;
+
+        __DMB(); /* finish reading before the producer may reuse the slot */
+        ch->tail = ch->tail + 1U;
+        if (ch->have_edge == 0U)
+        {
+            ch->have_edge = 1U;
+            ch->last_edge = t;
+            ch->stats.pulses++;
+            continue;
+        }
+
+        p = t - ch->last_edge;
+        if ((ch->hist_n == SPEED_MEDIAN_N) && (p < (med / SPEED_GLITCH_DIV)))
+        {
+            ch->stats.glitches++;
+            continue;   /* the next real edge is timed from the last good one */
+        }
+
+        if (count == 0U)
+        {
+            first = ch->last_edge;
+        }
+        count++;
+        ch->last_edge = t;
+        ch->stats.pulses++;
+
+        ch->hist[ch->hist_pos] = p;
+        ch->hist_pos = (uint8_t)((ch->hist_pos + 1U) % SPEED_MEDIAN_N);
+        if (ch->hist_n < SPEED_MEDIAN_N)
+        {
+            ch->hist_n++;
+        }
+        med = speed_median(ch);
+    }
+
+    if (ch->have_edge == 0U)
+    {
+        ch->freq_q16 = 0U;
+        return;
+    }
+
+    since = now - ch->last_edge;
+    if (since >= SPEED_TIMEOUT_US)
+    {
+        /* Stopped: start over from the next edge */
+        ch->have_edge = 0U;
+        ch->hist_n    = 0U;
+        ch->hist_pos  = 0U;
+        ch->freq_q16  = 0U;
+    }
+    else if (count >= SPEED_GATE_EDGES)
+    {
+        /* Gated: periods counted over the exact time they span */
+        ch->freq_q16 = (uint32_t)(((uint64_t)count * SPEED_MHZ_Q16) / (ch->last_edge - first));
+    }
+    else if (med != 0U)
+    {
+        /* Reciprocal; a late edge means the period is at least that long */
+        uint32_t period = (since > med) ? since : med;
+        ch->freq_q16 = (uint32_t)(SPEED_MHZ_Q16 / period);
+    }
+    else
+    {
+        ch->freq_q16 = 0U;   /* one edge so far */
+    }
+}
+
+void Speed_Update(void)
+{
+    uint8_t c;
+
+    for (c = 0U; c < (uint8_t)SPEED_CH_COUNT; c++)
+    {
+        speed_pass(&speed_chan[c]);
+    }
+}
+
+uint32_t Speed_Freq_Q16(speed_channel_t ch)
+{
+    return ((uint32_t)ch < (uint32_t)SPEED_CH_COUNT) ? speed_chan[ch].freq_q16 : 0U;
+}
+
+/* km/h = f * 3600 / pulses per km */
+uint32_t Speed_Kmh_Q16(void)
+{
+    return (uint32_t)(((uint64_t)speed_chan[SPEED_CH_VEHICLE].freq_q16 * 3600U) / SPEED_PULSES_PER_KM);
+}
+
+/* RPM = f * 60 / pulses per revolution */
+uint32_t Speed_Rpm_Q16(void)
+{
+    return (uint32_t)(((uint64_t)speed_chan[SPEED_CH_ENGINE].freq_q16 * 60U) / SPEED_PULSES_PER_REV);
+}
+
+speed_status_t Speed_Get_Stats(speed_channel_t ch, speed_stats_t *out)
+{
+    if (((uint32_t)ch >= (uint32_t)SPEED_CH_COUNT) || (out == NULL))
+    {
+        return SPEED_STATUS_INVALID_PARAM;
+    }
+    *out = speed_chan[ch].stats;
+    return SPEED_STATUS_OK;
+}
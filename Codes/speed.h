@@ -0,0 +1,94 @@
+/*
+ * File: speed.h
+ * Purpose: Vehicle speed and engine RPM from pulse inputs on TIMER2 capture (MISRA C:2012 aligned)
+ *
+ * TIMER2 free-runs at 1 MHz; CAP2.0 (P0.4) takes the vehicle speed sensor
+ * and CAP2.1 (P0.5) the engine speed pulse, both on rising edges. The
+ * capture ISR only stores the captured count in a per-channel ring; all
+ * arithmetic is done by Speed_Update() in one batched pass per task period.
+ *
+ * Per channel and pass:
+ * - each new period is checked against the median of the last
+ *   SPEED_MEDIAN_N periods; an edge closer than 1/SPEED_GLITCH_DIV of it
+ *   to the previous one is a glitch and is dropped;
+ * - at high rates (at least SPEED_GATE_EDGES periods in the pass) the
+ *   frequency is the period count over the exact time they span (gated
+ *   counting, timed edge to edge so there is no +/-1 count error);
+ * - at low rates it is the reciprocal of the median period, which
+ *   updates on every edge; while no edge arrives the time since the last
+ *   one bounds the period, so the reading decays smoothly to 0 and is
+ *   forced to 0 after SPEED_TIMEOUT_MS.
+ * Results are unsigned Q16.16 km/h and RPM.
+ */
+
+#ifndef SPEED_H
+#define SPEED_H
+
+#include <stdint.h>
+#include "clock_plan.h"
+
+/* Status codes for speed APIs */
+typedef enum
+{
+    SPEED_STATUS_OK = 0,
+    SPEED_STATUS_INVALID_PARAM = 1
+} speed_status_t;
+
+typedef enum
+{
+    SPEED_CH_VEHICLE = 0,    /* CAP2.0, P0.4 */
+    SPEED_CH_ENGINE = 1,     /* CAP2.1, P0.5 */
+    SPEED_CH_COUNT = 2
+} speed_channel_t;
+
+/* Sensor scaling */
+#define SPEED_PULSES_PER_KM               (4000U)
+#define SPEED_PULSES_PER_REV              (2U)     /* 4-cylinder ignition */
+
+/* Power/clock: PCONP bit 22, PCLKSEL1 bits [13:12] */
+#define PCONP_PCTIM2_MASK                 (1UL << 22)
+#define PCLKSEL1_PCLK_TIMER2_MASK         (3UL << 12)
+#define PCLKSEL1_PCLK_TIMER2_PLAN         (CLOCK_PLAN_PCLKSEL_BITS << 12)
+
+/* P0.4 CAP2.0, P0.5 CAP2.1 (PINSEL0 = 11); pull-ups left on for
+   open-collector sensors */
+#define PINSEL0_SPEED_MASK                ((3UL << 8) | (3UL << 10))
+#define PINSEL0_SPEED_FUNC                ((3UL << 8) | (3UL << 10))
+
+/* TIMER2 count rate and capture bits */
+#define SPEED_TIMER_HZ                    (1000000UL)
+#define SPEED_TIMER_PR                    ((CLOCK_PLAN_PCLK_HZ / SPEED_TIMER_HZ) - 1UL)
+#define SPEED_CCR_CAP0RE_CAP0I            ((1UL << 0) | (1UL << 2))
+#define SPEED_CCR_CAP1RE_CAP1I            ((1UL << 3) | (1UL << 5))
+#define SPEED_IR_CR0                      (1UL << 4)
+#define SPEED_IR_CR1                      (1UL << 5)
+
+/* Pass period and measurement parameters */
+#define SPEED_UPDATE_MS                   (20U)
+#define SPEED_RING                        (64U)    /* captures per channel between passes */
+#define SPEED_MEDIAN_N                    (5U)
+#define SPEED_GLITCH_DIV                  (4U)
+#define SPEED_GATE_EDGES                  (8U)
+#define SPEED_TIMEOUT_MS                  (2000U)
+
+/* Per-channel counters since power-up */
+typedef struct
+{
+    uint32_t pulses;      /* accepted edges */
+    uint32_t glitches;    /* edges rejected as glitches */
+    uint32_t overruns;    /* captures lost to a full ring */
+} speed_stats_t;
+
+/* Public API (main context unless noted) */
+void           Speed_Init(void);
+/* Batched pass over the captures since the last call; every SPEED_UPDATE_MS */
+void           Speed_Update(void);
+uint32_t       Speed_Kmh_Q16(void);
+uint32_t       Speed_Rpm_Q16(void);
+/* Pulse frequency of a channel, Q16.16 Hz */
+uint32_t       Speed_Freq_Q16(speed_channel_t ch);
+speed_status_t Speed_Get_Stats(speed_channel_t ch, speed_stats_t *out);
+
+void TIMER2_IRQHandler(void);
+
+#endif /* SPEED_H */
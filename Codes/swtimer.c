@@ -0,0 +1,220 @@
+/*
+ * File: swtimer.c
+ * Purpose: Deadline-sorted software timers, MR0 armed with the earliest one.
+ * Notes: Deadlines are absolute TC counts compared with wrap-safe signed
+ *        differences. Periodic timers advance from their previous deadline
+ *        through a timebase step, so a late ISR never shifts the phase.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "timer.h"
+#include "timebase.h"
+#include "swtimer.h"
+#include "critical.h"
+
+static swtimer_t *swtimer_head = NULL;
+
+/* a is at or after b, valid while |a - b| < 2^31 */
+static uint8_t swtimer_reached(uint32_t a, uint32_t b)
+{
+    return ((int32_t)(a - b) >= 0) ? 1U : 0U;
+}
+
+static void swtimer_insert(swtimer_t *t)
+{
+    swtimer_t **link = &swtimer_head;
+
+    /* Equal deadlines keep insertion order */
+    while ((*link != NULL) && (swtimer_reached(t->deadline, (*link)->deadline) != 0U))
+    {
+        link = &(*link)->next;
+    }
+    t->next = *link;
+    *link   = t;
+}
+
+static void swtimer_remove(swtimer_t *t)
+{
+    swtimer_t **link = &swtimer_head;
+
+    while (*link != NULL)
+    {
+        if (*link == t)
+        {
+            *link = t->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+    t->next = NULL;
+}
+
+/* Arm MR0 for the head timer, or stop interrupting when nothing is queued */
+static void swtimer_program(void)
+{
+    if (swtimer_head == NULL)
+    {
+        LPC_TIM0->MCR &= ~MCR_MR0I;
+        return;
+    }
+
+    LPC_TIM0->MR0  = swtimer_head->deadline;
+    LPC_TIM0->MCR |= MCR_MR0I;
+
+    /* Deadline may already have slipped past TC: the match would only come
+       after a full wrap, so run the ISR now instead */
+    if (swtimer_reached(LPC_TIM0->TC, swtimer_head->deadline) != 0U)
+    {
+        NVIC_SetPendingIRQ(TIMER0_IRQn);
+    }
+}
+
+static uint8_t swtimer_ms_to_counts(uint32_t ms, uint32_t *counts)
+{
+    uint64_t c = ((uint64_t)ms * TIMER0_TICK_HZ) / 1000U;
+
+    if ((c == 0U) || (c > SWTIMER_MAX_DELAY_COUNTS))
+    {
+        return 0U;
+    }
+    *counts = (uint32_t)c;
+    return 1U;
+}
+
+void SwTimer_Init(void)
+{
+    uint32_t primask = Critical_Enter();
+    swtimer_head = NULL;
+    swtimer_program();
+    Critical_Exit(primask);
+}
+
+swtimer_status_t SwTimer_Start(swtimer_t *t, uint32_t first_ms, uint32_t period_ms,
+                               swtimer_cb_t cb, void *ctx)
+{
+    uint32_t first;
+    uint32_t primask;
+
+    if ((t == NULL) || (cb == NULL) || (swtimer_ms_to_counts(first_ms, &first) == 0U))
+    {
+        return SWTIMER_STATUS_INVALID_PARAM;
+    }
+    if (period_ms != 0U)
+    {
+        uint32_t check;
+        if ((swtimer_ms_to_counts(period_ms, &check) == 0U) ||
+            (Timebase_Step_Init(&t->period, period_ms, TIMER0_TICK_HZ) != TIMEBASE_STATUS_OK))
+        {
+            return SWTIMER_STATUS_INVALID_PARAM;
+        }
+    }
+
+    primask = Critical_Enter();
+    if (t->active != 0U)
+    {
+        swtimer_remove(t);
+    }
+    t->cb       = cb;
+    t->ctx      = ctx;
+    t->periodic = (period_ms != 0U) ? 1U : 0U;
+    t->active   = 1U;
+    t->deadline = LPC_TIM0->TC + first;
+    swtimer_insert(t);
+    swtimer_program();
+    Critical_Exit(primask);
+
+    return SWTIMER_STATUS_OK;
+}
+
+swtimer_status_t SwTimer_Start_At(swtimer_t *t, uint32_t deadline,
+                                  swtimer_cb_t cb, void *ctx)
+{
+    uint32_t primask;
+
+    if ((t == NULL) || (cb == NULL))
+    {
+        return SWTIMER_STATUS_INVALID_PARAM;
+    }
+
+    primask = Critical_Enter();
+    if (t->active != 0U)
+    {
+        swtimer_remove(t);
+    }
+    t->cb       = cb;
+    t->ctx      = ctx;
+    t->periodic = 0U;
+    t->active   = 1U;
+    t->deadline = deadline;
+    swtimer_insert(t);
+    swtimer_program();
+    Critical_Exit(primask);
+
+    return SWTIMER_STATUS_OK;
+}
+
+void SwTimer_Stop(swtimer_t *t)
+{
+    uint32_t primask;
+
+    if (t == NULL)
+    {
+        return;
+    }
+
+    primask = Critical_Enter();
+    if (t->active != 0U)
+    {
+        swtimer_remove(t);
+        t->active = 0U;
+        swtimer_program();
+    }
+    Critical_Exit(primask);
+}
+
+uint8_t SwTimer_Is_Active(const swtimer_t *t)
+{
+    return (t != NULL) ? t->active : 0U;
+}
+
+uint32_t SwTimer_Now(void)
+{
+    return LPC_TIM0->TC;
+}
+
+void SwTimer_Isr(void)
+{
+    swtimer_t *t;
+    uint32_t   primask;
+
+    for (;;)
+    {
+        /* Higher-priority ISRs may start/stop timers: guard the list */
+        primask = Critical_Enter();
+        t = swtimer_head;
+        if ((t == NULL) || (swtimer_reached(LPC_TIM0->TC, t->deadline) == 0U))
+        {
+            swtimer_program();
+            Critical_Exit(primask);
+            break;
+        }
+
+        swtimer_head = t->next;
+        t->next      = NULL;
+        if (t->periodic != 0U)
+        {
+            t->deadline += Timebase_Step_Next(&t->period);
+            swtimer_insert(t);
+        }
+        else
+        {
+            t->active = 0U;
+        }
+        Critical_Exit(primask);
+
+        /* May start/stop timers, including itself */
+        t->cb(t->ctx);
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * File: swtimer.h
+ * Purpose: Tickless software timers on TIMER0 match registers (MISRA C:2012 aligned)
+ *
+ * TIMER0 free-runs; registered timers are kept sorted by deadline and MR0
+ * is programmed with the earliest one, so TIMER0 only interrupts when a
+ * timer is actually due. Callbacks run in TIMER0 ISR context.
+ */
+
+#ifndef SWTIMER_H
+#define SWTIMER_H
+
+#include <stdint.h>
+#include "timebase.h"
+
+/* Status codes for software timer APIs */
+typedef enum
+{
+    SWTIMER_STATUS_OK = 0,
+    SWTIMER_STATUS_INVALID_PARAM = 1
+} swtimer_status_t;
+
+typedef void (*swtimer_cb_t)(void *ctx);
+
+/* Timer object, owned (statically allocated) by the client */
+typedef struct swtimer
+{
+    struct swtimer  *next;      /* deadline-ordered list link */
+    uint32_t         deadline;  /* absolute TC value of the next expiry */
+    timebase_step_t  period;    /* drift-free reload for periodic timers */
+    swtimer_cb_t     cb;
+    void            *ctx;
+    uint8_t          periodic;
+    uint8_t          active;
+} swtimer_t;
+
+/* Longest delay that still compares correctly across a TC wrap */
+#define SWTIMER_MAX_DELAY_COUNTS          (0x7FFFFFFFUL)
+
+/* Public API */
+void             SwTimer_Init(void);
+/* First expiry after first_ms (>0), then every period_ms; period_ms == 0 => one-shot */
+swtimer_status_t SwTimer_Start(swtimer_t *t, uint32_t first_ms, uint32_t period_ms,
+                               swtimer_cb_t cb, void *ctx);
+/* One-shot at an absolute TC value; a deadline already passed fires at once.
+   The deadline must lie within SWTIMER_MAX_DELAY_COUNTS of now */
+swtimer_status_t SwTimer_Start_At(swtimer_t *t, uint32_t deadline,
+                                  swtimer_cb_t cb, void *ctx);
+void             SwTimer_Stop(swtimer_t *t);
+uint8_t          SwTimer_Is_Active(const swtimer_t *t);
+/* Current free-running TIMER0 count */
+uint32_t         SwTimer_Now(void);
+/* Expire due timers and re-arm MR0; called from TIMER0_IRQHandler */
+void             SwTimer_Isr(void);
+
+#endif /* SWTIMER_H */
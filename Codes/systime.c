@@ -0,0 +1,160 @@
+/*
+ * File: systime.c
+ * Purpose: 64-bit microsecond time from TIMER0 TC plus a wrap epoch.
+ * Notes: MR3 matches at 0xFFFFFFFF, one count before TC wraps, but TC
+ *        holds that value for another microsecond. Systime_Isr() only bumps
+ *        the epoch once TC has wrapped (below 0x80000000); until then it
+ *        leaves IR_MR3 pending and the interrupt re-enters. A reader that
+ *        runs while IR_MR3 is pending (masked, from a higher-priority ISR, or
+ *        in that last microsecond) adds the epoch itself only if TC is
+ *        already past the wrap, so no context can observe time going
+ *        backwards or jumping ahead.
+ */
+
+#include "LPC17xx.h"
+#include <stdint.h>
+#include <stddef.h>
+#include "timer.h"
+#include "systime.h"
+#include "critical.h"
+
+#if (CLOCK_PLAN_TIMER0_TICK_HZ != 1000000UL)
+#error "systime: TIMER0 must count microseconds"
+#endif
+
+static volatile uint32_t systime_epoch = 0U;
+
+void Systime_Init(void)
+{
+    uint32_t primask = Critical_Enter();
+    systime_epoch  = 0U;
+    LPC_TIM0->MR3  = SYSTIME_MR3_WRAP;
+    LPC_TIM0->IR   = IR_MR3;
+    LPC_TIM0->MCR |= MCR_MR3I;
+    Critical_Exit(primask);
+}
+
+void Systime_Isr(void)
+{
+    /* Clear and count together so a reader never sees one without the other;
+       not before the wrap, or the epoch would run one count ahead of TC */
+    uint32_t primask = Critical_Enter();
+    if (((LPC_TIM0->IR & IR_MR3) != 0U) && (LPC_TIM0->TC < 0x80000000UL))
+    {
+        LPC_TIM0->IR = IR_MR3; /* write-1-to-clear */
+        systime_epoch++;
+    }
+    Critical_Exit(primask);
+}
+
+uint64_t time_now_us(void)
+{
+    uint32_t primask = Critical_Enter();
+    uint32_t hi = systime_epoch;
+    uint32_t lo = LPC_TIM0->TC;
+
+    /* Wrap happened but Systime_Isr() has not counted it yet */
+    if (((LPC_TIM0->IR & IR_MR3) != 0U) && (lo < 0x80000000UL))
+    {
+        hi++;
+    }
+    Critical_Exit(primask);
+
+    return ((uint64_t)hi << 32) | (uint64_t)lo;
+}
+
+uint64_t time_now_ms(void)
+{
+    return time_now_us() / 1000U;
+}
+
+void Deadline_Set(deadline_t *d, uint32_t ms)
+{
+    Deadline_Set_Us(d, (uint64_t)ms * 1000U);
+}
+
+void Deadline_Set_Us(deadline_t *d, uint64_t us)
+{
+    if (d != NULL)
+    {
+        d->expires_us = time_now_us() + us;
+    }
+}
+
+void Deadline_Set_At(deadline_t *d, uint64_t at_us)
+{
+    if (d != NULL)
+    {
+        d->expires_us = at_us;
+    }
+}
+
+uint8_t Deadline_Expired(const deadline_t *d)
+{
+    return ((d == NULL) || (time_now_us() >= d->expires_us)) ? 1U : 0U;
+}
+
+uint64_t Deadline_Remaining_Us(const deadline_t *d)
+{
+    uint64_t now;
+
+    if (d == NULL)
+    {
+        return 0U;
+    }
+    now = time_now_us();
+    return (now >= d->expires_us) ? 0U : (d->expires_us - now);
+}
+
+static void deadline_arm(deadline_t *d);
+
+static void deadline_fire(void *ctx)
+{
+    deadline_t *d = (deadline_t *)ctx;
+
+    if (Deadline_Expired(d) != 0U)
+    {
+        d->cb(d->ctx);
+    }
+    else
+    {
+        deadline_arm(d); /* far deadline: next hop */
+    }
+}
+
+/* The low 32 bits of time_now_us() are TC, so the swtimer deadline is the
+   expiry truncated, capped at the longest wrap-safe distance */
+static void deadline_arm(deadline_t *d)
+{
+    uint64_t now    = time_now_us();
+    uint64_t target = now;
+
+    if (d->expires_us > now)
+    {
+        uint64_t rem = d->expires_us - now;
+        target = now + ((rem > SWTIMER_MAX_DELAY_COUNTS) ? SWTIMER_MAX_DELAY_COUNTS : rem);
+    }
+    (void)SwTimer_Start_At(&d->timer, (uint32_t)target, deadline_fire, (void *)d);
+}
+
+systime_status_t Deadline_Await(deadline_t *d, swtimer_cb_t cb, void *ctx)
+{
+    if ((d == NULL) || (cb == NULL))
+    {
+        return SYSTIME_STATUS_INVALID_PARAM;
+    }
+
+    SwTimer_Stop(&d->timer);
+    d->cb  = cb;
+    d->ctx = ctx;
+    deadline_arm(d);
+    return SYSTIME_STATUS_OK;
+}
+
+void Deadline_Cancel(deadline_t *d)
+{
+    if (d != NULL)
+    {
+        SwTimer_Stop(&d->timer);
+    }
+}
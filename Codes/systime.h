@@ -0,0 +1,61 @@
+/*
+ * File: systime.h
+ * Purpose: 64-bit monotonic time and awaitable deadlines (MISRA C:2012 aligned)
+ *
+ * TIMER0 free-runs at 1 MHz; the 32-bit TC is extended to 64 bits by an
+ * epoch counter, bumped once TC has wrapped past the MR3 match at its last count.
+ * time_now_us() is consistent from main and any ISR, even when the wrap
+ * interrupt is still pending. A deadline is an absolute 64-bit expiry that
+ * can be polled or awaited: Deadline_Await() runs a callback (TIMER0 ISR
+ * context) once it has passed, so callers need not spin.
+ */
+
+#ifndef SYSTIME_H
+#define SYSTIME_H
+
+#include <stdint.h>
+#include "swtimer.h"
+
+/* Status codes for systime APIs */
+typedef enum
+{
+    SYSTIME_STATUS_OK = 0,
+    SYSTIME_STATUS_INVALID_PARAM = 1
+} systime_status_t;
+
+/* TIMER0 match 3 is reserved for the wrap epoch */
+#define MCR_MR3I                            (1U << 9U)       /* Interrupt on MR3 match */
+#define IR_MR3                              (1U << 3U)
+#define SYSTIME_MR3_WRAP                    (0xFFFFFFFFUL)   /* last count before TC wraps */
+
+typedef struct
+{
+    uint64_t      expires_us;   /* absolute time_now_us() value */
+    swtimer_cb_t  cb;           /* set by Deadline_Await */
+    void         *ctx;
+    swtimer_t     timer;        /* one-shot used by Deadline_Await */
+} deadline_t;
+
+/* Public API */
+/* Arm the wrap match; call before TIMER0 is enabled */
+void             Systime_Init(void);
+/* Count the TC wrap; called from TIMER0_IRQHandler */
+void             Systime_Isr(void);
+
+uint64_t         time_now_us(void);
+uint64_t         time_now_ms(void);
+
+void             Deadline_Set(deadline_t *d, uint32_t ms);
+void             Deadline_Set_Us(deadline_t *d, uint64_t us);
+/* Absolute expiry in time_now_us() units */
+void             Deadline_Set_At(deadline_t *d, uint64_t at_us);
+uint8_t          Deadline_Expired(const deadline_t *d);
+/* Microseconds left, 0 once expired */
+uint64_t         Deadline_Remaining_Us(const deadline_t *d);
+/* Run cb(ctx) once the deadline has passed (at once if it already has).
+   Deadlines beyond one swtimer range are reached in several hops.
+   Call again after Deadline_Set to follow a moved deadline */
+systime_status_t Deadline_Await(deadline_t *d, swtimer_cb_t cb, void *ctx);
+void             Deadline_Cancel(deadline_t *d);
+
+#endif /* SYSTIME_H */
@@ -0,0 +1,51 @@
+/*
+ * File: timebase.c
+ * Purpose: Phase-accumulator period generator for timer match values.
+ * Notes: Hardware independent so it can be exercised on the host
+ *        (see sim_timebase_drift.c).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "timebase.h"
+
+timebase_status_t Timebase_Step_Init(timebase_step_t *step, uint32_t period_ms, uint32_t tick_hz)
+{
+    uint64_t total;
+
+    if ((step == NULL) || (period_ms == 0U) || (tick_hz == 0U))
+    {
+        return TIMEBASE_STATUS_INVALID_PARAM;
+    }
+
+    /* period in counts = period_ms * tick_hz / 1000, kept as whole + remainder */
+    total = (uint64_t)period_ms * (uint64_t)tick_hz;
+    if ((total / TIMEBASE_FRAC_DEN) == 0U)
+    {
+        return TIMEBASE_STATUS_INVALID_PARAM; /* period shorter than one count */
+    }
+    if ((total / TIMEBASE_FRAC_DEN) > 0xFFFFFFFEUL)
+    {
+        return TIMEBASE_STATUS_INVALID_PARAM; /* does not fit a 32-bit match */
+    }
+
+    step->counts = (uint32_t)(total / TIMEBASE_FRAC_DEN);
+    step->rem    = (uint32_t)(total % TIMEBASE_FRAC_DEN);
+    step->acc    = 0U;
+
+    return TIMEBASE_STATUS_OK;
+}
+
+uint32_t Timebase_Step_Next(timebase_step_t *step)
+{
+    uint32_t counts = step->counts;
+
+    step->acc += step->rem;
+    if (step->acc >= TIMEBASE_FRAC_DEN)
+    {
+        step->acc -= TIMEBASE_FRAC_DEN;
+        counts++;
+    }
+
+    return counts;
+}
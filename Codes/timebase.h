@@ -0,0 +1,38 @@
+/*
+ * File: timebase.h
+ * Purpose: Drift-free conversion of millisecond periods to timer counts (MISRA C:2012 aligned)
+ *
+ * A period of P ms at a count rate of F Hz is P*F/1000 counts, which is not
+ * an integer in general. Each step hands out the whole part and carries the
+ * remainder in a Bresenham-style phase accumulator, so a run of N periods
+ * always totals floor(N*P*F/1000) or one count more: no cumulative drift.
+ */
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+
+/* Denominator of the fractional part (periods are given in ms) */
+#define TIMEBASE_FRAC_DEN                 (1000UL)
+
+typedef struct
+{
+    uint32_t counts;   /* whole timer counts per period */
+    uint32_t rem;      /* fractional counts per period, in 1/TIMEBASE_FRAC_DEN */
+    uint32_t acc;      /* phase accumulator, 0 .. TIMEBASE_FRAC_DEN-1 */
+} timebase_step_t;
+
+/* Status codes for timebase APIs */
+typedef enum
+{
+    TIMEBASE_STATUS_OK = 0,
+    TIMEBASE_STATUS_INVALID_PARAM = 1
+} timebase_status_t;
+
+/* Prepare a step generator for period_ms at tick_hz timer counts per second */
+timebase_status_t Timebase_Step_Init(timebase_step_t *step, uint32_t period_ms, uint32_t tick_hz);
+/* Length of the next period in timer counts (counts or counts + 1) */
+uint32_t Timebase_Step_Next(timebase_step_t *step);
+
+#endif /* TIMEBASE_H */
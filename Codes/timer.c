@@ -1,12 +1,26 @@
 #include "LPC17xx.h"
+#include <stddef.h>
 #include "timer.h"
+#include "swtimer.h"
+#include "twheel.h"
+#include "systime.h"
+#include "evq.h"
+#include "sched.h"
+#include "critical.h"
 
-volatile uint8_t LED1_flag = 0;
-volatile uint8_t LED2_flag = 0;
-volatile uint8_t Buzzer_flag = 0;
-volatile uint16_t counter1 = 0;
-volatile uint16_t counter2 = 0;
-volatile uint16_t counter3 = 0;
+/* Tick events from the TIMER0 ISR (sole producer), drained by the main loop */
+evq_t timer_evq;
+
+static uint8_t led1_evt   = (uint8_t)EVT_LED1_TICK;
+static uint8_t led2_evt   = (uint8_t)EVT_LED2_TICK;
+static uint8_t buzzer_evt = (uint8_t)EVT_BUZZER_TICK;
+
+static void post_tick(void *ctx)
+{
+    const uint8_t *id = (const uint8_t *)ctx;
+    (void)EvQ_Post(&timer_evq, *id, 0U); /* a full ring is counted in dropped */
+    Sched_Kick();                         /* wake the event tasks */
+}
 
 
 timer_status_t Timer_Init(void)
@@ -14,37 +28,64 @@ timer_status_t Timer_Init(void)
     /* Power up TIMER0 (PCONP bit 1) */
     LPC_SC->PCONP |= (1U << 1U);
 
-    /* Set Timer0 PCLK to CCLK/4 => 00 */
+    /* Set Timer0 PCLK divider from the clock plan */
     LPC_SC->PCLKSEL0 &= ~PCLKSEL0_PCLK_TIMER0_MASK;
+    LPC_SC->PCLKSEL0 |=  PCLKSEL0_PCLK_TIMER0_PLAN;
     
     /* Setting prescaler */
     LPC_TIM0->PR = PR_VALUE;
 
-    /* Match value for 1ms period */
-    LPC_TIM0->MR0 = MR0_VALUE;
-
-    /* Enable interrupt flag and reset on MR0 match */
-    LPC_TIM0->MCR = (MCR_MR0I | MCR_MR0R);
+    /* Free-running TC: no reset on match; MR0 interrupt is armed by swtimer */
+    LPC_TIM0->MCR = 0U;
 
     /* Clear any pending match flags just in case */
     LPC_TIM0->IR = IR_MR0;
 
+    /* MR3 counts TC wraps for the 64-bit time */
+    Systime_Init();
+
     /* Reset time counter, then enable timer */
     LPC_TIM0->TCR = TCR_COUNT_RESET;
     LPC_TIM0->TCR = TCR_COUNT_ENABLE;
 
     /* Enabling the interruptter*/
     NVIC_EnableIRQ(TIMER0_IRQn);
+
+    SwTimer_Init();
+    TWheel_Init();
+    EvQ_Init(&timer_evq);
+
+    /* Periodic ticks go on the wheel, one-shot deadlines on swtimer.
+       Documented tick periods: LED1 350 ms, LED2 400 ms, buzzer 20 ms */
+    if ((TWheel_Start(TIMER_LED1_PERIOD_MS,   TIMER_LED1_PERIOD_MS,
+                      post_tick, (void *)&led1_evt)   == TWHEEL_INVALID_HANDLE) ||
+        (TWheel_Start(TIMER_LED2_PERIOD_MS,   TIMER_LED2_PERIOD_MS,
+                      post_tick, (void *)&led2_evt)   == TWHEEL_INVALID_HANDLE) ||
+        (TWheel_Start(TIMER_BUZZER_PERIOD_MS, TIMER_BUZZER_PERIOD_MS,
+                      post_tick, (void *)&buzzer_evt) == TWHEEL_INVALID_HANDLE))
+    {
+        return TIMER_STATUS_INVALID_PARAM;
+    }
     
     return TIMER_STATUS_OK;
 }
 
-/* Blocking delay in milliseconds using TC polling only.
- * Compatible with NVIC-driven MR0 interrupts. Does not read/write IR/MCR.
- * Assumes MR0R is configured for a 1 ms period (TC wraps every 1 ms).
+static void delay_wake(void *ctx)
+{
+    (void)ctx; /* only here to end __WFI */
+}
+
+/* Blocking delay in milliseconds on the 64-bit time base.
+ * A deadline wakes the core from __WFI instead of polling TC, and the
+ * 64-bit time cannot lose a wrap however long interrupts keep us away.
+ * Main context only.
  */
 timer_status_t delay_ms(uint32_t ms)
 {
+    static deadline_t delay_deadline;
+    uint32_t primask;
+    uint8_t done = 0U;
+
     if (ms == 0U)
     {
         return TIMER_STATUS_INVALID_PARAM;
@@ -56,20 +97,22 @@ timer_status_t delay_ms(uint32_t ms)
         return TIMER_STATUS_NOT_READY;
     }
 
-    /* Count TC wraps (each wrap = 1 ms when MR0R used) */
+    Deadline_Set(&delay_deadline, ms);
+    (void)Deadline_Await(&delay_deadline, delay_wake, NULL);
+    while (done == 0U)
     {
-        uint32_t prev = LPC_TIM0->TC;
-        while (ms > 0U)
+        /* Check and sleep with PRIMASK set, so a deadline IRQ between the
+           two stays pending and ends the __WFI instead of being missed */
+        primask = Critical_Enter();
+        done = Deadline_Expired(&delay_deadline);
+        if (done == 0U)
         {
-            uint32_t curr = LPC_TIM0->TC;
-            if (curr < prev)
-            {
-                /* TC wrapped due to MR0R => elapsed 1 ms */
-                ms--;
-            }
-            prev = curr;
+            __WFI();
         }
+        Critical_Exit(primask); /* the waking ISR runs here */
     }
+    Deadline_Cancel(&delay_deadline);
+
     return TIMER_STATUS_OK;
 }
 
@@ -80,30 +123,11 @@ void TIMER0_IRQHandler(void)
     if ((LPC_TIM0->IR & IR_MR0) != 0U)
     {
         LPC_TIM0->IR = IR_MR0; /* write-1-to-clear */
-        counter1++;
-        counter2++;
-        counter3++;
-    }
-
-    /* Match documented 350ms toggle for LED1 (350ms) */
-    if (counter1 >= 350U)
-    {
-        LED1_flag ^= 1U;
-        counter1 = 0U;
-    }
-
-    /* Match documented 400ms toggle for LED2 (400ms) */
-    if (counter2 >= 400U)
-    {
-        LED2_flag ^= 1U;
-        counter2 = 0U;
-    }
-
-    if (counter3 >= 20U)
-    {
-        Buzzer_flag ^= 1U;
-        counter3 = 0U;
     }
 
+    /* Wrap epoch first so callbacks see the extended time */
+    Systime_Isr();
 
+    /* Also entered via NVIC pend when a deadline was armed late */
+    SwTimer_Isr();
 }
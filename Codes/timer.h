@@ -6,6 +6,8 @@
 #define TIMER_H
 
 #include <stdint.h>
+#include "clock_plan.h"
+#include "evq.h"
 
 /* Status codes for timer APIs */
 typedef enum
@@ -18,10 +20,12 @@ typedef enum
 /* Selecting the peripheral clock for TIMER0 (PCLKSEL0 bits [3:2]) */
 /* Mask for the 2-bit TIMER0 field (both bits) */
 #define PCLKSEL0_PCLK_TIMER0_MASK           (3U << 2U)
+#define PCLKSEL0_PCLK_TIMER0_PLAN           (CLOCK_PLAN_PCLKSEL_BITS << 2U)
 
 /* Timer configuration values */
-#define PR_VALUE                            (249U)           /* Prescaler value */
-#define MR0_VALUE                           (100U)           /* Match register 0 value */
+#define PR_VALUE                            (CLOCK_PLAN_TIMER0_PR)             /* Prescaler value */
+#define TIMER0_TICK_HZ                      (CLOCK_PLAN_TIMER0_TICK_HZ)        /* TC count rate */
+/* TC free-runs and wraps at 2^32 counts; MR0 holds the next swtimer deadline */
 
 /* Match Control Register bits */
 #define MCR_MR0I                            (1U << 0U)       /* Interrupt on MR0 match */
@@ -34,9 +38,18 @@ typedef enum
 #define TCR_COUNT_RESET                     (1U << 1U)       /* Reset */
 #define TCR_COUNT_ENABLE                    (1U << 0U)       /* Enable */
 
-/* Initialize Timer0 for periodic match on MR0 */
+/* Tick event periods; timelines are drift-free, so consumers may derive
+   phase from event timestamps */
+#define TIMER_LED1_PERIOD_MS                (350U)
+#define TIMER_LED2_PERIOD_MS                (400U)
+#define TIMER_BUZZER_PERIOD_MS              (20U)
+
+/* EVT_LED1_TICK / EVT_LED2_TICK / EVT_BUZZER_TICK posted by the TIMER0 ISR */
+extern evq_t timer_evq;
+
+/* Initialize free-running Timer0 and the software timer service */
 timer_status_t Timer_Init(void);
-/* Blocking delay using IR.MR0 polling */
+/* Blocking delay on the 64-bit time base; sleeps in __WFI (main context only) */
 timer_status_t delay_ms(uint32_t ms);
 
 void TIMER0_IRQHandler(void);
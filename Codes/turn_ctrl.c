@@ -0,0 +1,166 @@
+/*
+ * File: turn_ctrl.c
+ * Purpose: Last-press-wins arbitration of the turn and hazard switches.
+ * Notes: Edges are taken per tick against the levels of the previous tick,
+ *        so a press shorter than one tick is ignored, as in the pseudocode.
+ *        Unlike the pseudocode, a new owner only suppresses switches that
+ *        are on at that moment: suppressing one that is off would make its
+ *        next press be ignored, which is not last-press-wins.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "turn_ctrl.h"
+
+static uint8_t        turn_level[TURN_IN_COUNT];
+static uint8_t        turn_prev[TURN_IN_COUNT];
+static uint8_t        turn_suppressed[TURN_IN_COUNT];
+static uint64_t       turn_edge_us[TURN_IN_COUNT];
+static turn_owner_t   turn_owner;
+
+/* Owner change not yet on the lamps */
+static uint8_t        turn_pending;
+static uint64_t       turn_pending_edge_us;
+static turn_latency_t turn_latency;
+
+static const turn_owner_t turn_owner_of[TURN_IN_COUNT] =
+{
+    TURN_OWNER_LEFT,
+    TURN_OWNER_RIGHT,
+    TURN_OWNER_HAZARD
+};
+
+void TurnCtrl_Init(void)
+{
+    uint8_t i;
+
+    for (i = 0U; i < (uint8_t)TURN_IN_COUNT; i++)
+    {
+        turn_level[i]      = 0U;
+        turn_prev[i]       = 0U;
+        turn_suppressed[i] = 0U;
+        turn_edge_us[i]    = 0U;
+    }
+    turn_owner   = TURN_OWNER_IDLE;
+    turn_pending = 0U;
+    TurnCtrl_Reset_Latency();
+}
+
+turn_ctrl_status_t TurnCtrl_Set_Input(turn_input_t in, uint8_t level, uint64_t edge_us)
+{
+    uint8_t want = (level != 0U) ? 1U : 0U;
+
+    if ((uint32_t)in >= (uint32_t)TURN_IN_COUNT)
+    {
+        return TURN_CTRL_STATUS_INVALID_PARAM;
+    }
+    if (want != turn_level[in])
+    {
+        turn_level[in]   = want;
+        turn_edge_us[in] = edge_us;
+    }
+    return TURN_CTRL_STATUS_OK;
+}
+
+uint8_t TurnCtrl_Tick(void)
+{
+    turn_owner_t before = turn_owner;
+    uint64_t     cause_us = 0U;
+    uint8_t      i;
+    uint8_t      j;
+
+    /* A release makes a switch eligible again; releasing the owner ends
+       its mode with no fallback to another switch still on */
+    for (i = 0U; i < (uint8_t)TURN_IN_COUNT; i++)
+    {
+        if ((turn_level[i] == 0U) && (turn_prev[i] != 0U))
+        {
+            turn_suppressed[i] = 0U;
+            if (turn_owner == turn_owner_of[i])
+            {
+                turn_owner = TURN_OWNER_IDLE;
+                cause_us   = turn_edge_us[i];
+            }
+        }
+    }
+
+    /* Any press takes over; with several in one tick the later input
+       (HAZARD last) wins, as in the pseudocode */
+    for (i = 0U; i < (uint8_t)TURN_IN_COUNT; i++)
+    {
+        if ((turn_level[i] != 0U) && (turn_prev[i] == 0U) && (turn_suppressed[i] == 0U))
+        {
+            turn_owner = turn_owner_of[i];
+            cause_us   = turn_edge_us[i];
+            for (j = 0U; j < (uint8_t)TURN_IN_COUNT; j++)
+            {
+                turn_suppressed[j] = ((j != i) && (turn_level[j] != 0U)) ? 1U : 0U;
+            }
+        }
+    }
+
+    for (i = 0U; i < (uint8_t)TURN_IN_COUNT; i++)
+    {
+        turn_prev[i] = turn_level[i];
+    }
+
+    if (turn_owner == before)
+    {
+        return 0U;
+    }
+    if (turn_pending == 0U)
+    {
+        turn_pending_edge_us = cause_us; /* a later change before the latch keeps the first edge */
+        turn_pending         = 1U;
+    }
+    return 1U;
+}
+
+turn_owner_t TurnCtrl_Owner(void)
+{
+    return turn_owner;
+}
+
+uint8_t TurnCtrl_Latency_Pending(void)
+{
+    return turn_pending;
+}
+
+void TurnCtrl_Output_Latched(uint64_t now_us)
+{
+    uint32_t dt;
+
+    if (turn_pending == 0U)
+    {
+        return;
+    }
+    turn_pending = 0U;
+
+    dt = (now_us > turn_pending_edge_us) ? (uint32_t)(now_us - turn_pending_edge_us) : 0U;
+    turn_latency.last_us = dt;
+    if (dt > turn_latency.max_us)
+    {
+        turn_latency.max_us = dt;
+    }
+    if (dt > TURN_CTRL_BUDGET_US)
+    {
+        turn_latency.over_budget++;
+    }
+    turn_latency.samples++;
+}
+
+void TurnCtrl_Get_Latency(turn_latency_t *out)
+{
+    if (out != NULL)
+    {
+        *out = turn_latency;
+    }
+}
+
+void TurnCtrl_Reset_Latency(void)
+{
+    turn_latency.last_us     = 0U;
+    turn_latency.max_us      = 0U;
+    turn_latency.samples     = 0U;
+    turn_latency.over_budget = 0U;
+}
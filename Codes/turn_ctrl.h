@@ -0,0 +1,74 @@
+/*
+ * File: turn_ctrl.h
+ * Purpose: Turn/hazard switch arbitration, last press wins (MISRA C:2012 aligned)
+ *
+ * Implements Plans/Indicators logic/pseudocode_Indicators.c on the
+ * scheduler: a rising edge on LEFT, RIGHT or HAZARD takes exclusive
+ * ownership at once and suppresses the other switches that are still on
+ * until they are released; releasing the owning switch returns to idle
+ * with no fallback. The owner value is the Indicator()/Buzzer() direction.
+ *
+ * Latency from the switch edge to the first lamp frame latched for the new
+ * owner is measured against TURN_CTRL_BUDGET_US.
+ */
+
+#ifndef TURN_CTRL_H
+#define TURN_CTRL_H
+
+#include <stdint.h>
+
+/* Arbitration period */
+#define TURN_CTRL_TICK_MS                 (5U)
+
+/* Edge to first lamp frame */
+#define TURN_CTRL_BUDGET_US               (10000U)
+
+/* Status codes for turn controller APIs */
+typedef enum
+{
+    TURN_CTRL_STATUS_OK = 0,
+    TURN_CTRL_STATUS_INVALID_PARAM = 1
+} turn_ctrl_status_t;
+
+typedef enum
+{
+    TURN_IN_LEFT = 0,
+    TURN_IN_RIGHT = 1,
+    TURN_IN_HAZARD = 2,
+    TURN_IN_COUNT = 3
+} turn_input_t;
+
+/* Values match the Indicator()/Buzzer() directions */
+typedef enum
+{
+    TURN_OWNER_IDLE = 0,
+    TURN_OWNER_LEFT = 1,
+    TURN_OWNER_RIGHT = 2,
+    TURN_OWNER_HAZARD = 3
+} turn_owner_t;
+
+/* Edge-to-lamp latency since the last reset */
+typedef struct
+{
+    uint32_t last_us;
+    uint32_t max_us;
+    uint32_t samples;
+    uint32_t over_budget;   /* samples above TURN_CTRL_BUDGET_US */
+} turn_latency_t;
+
+/* Public API (main context) */
+void               TurnCtrl_Init(void);
+/* Debounced switch level; edge_us is when it changed (ignored if it did not) */
+turn_ctrl_status_t TurnCtrl_Set_Input(turn_input_t in, uint8_t level, uint64_t edge_us);
+/* Arbitrate the edges seen since the last call; returns 1 if the owner changed.
+   Call every TURN_CTRL_TICK_MS */
+uint8_t            TurnCtrl_Tick(void);
+turn_owner_t       TurnCtrl_Owner(void);
+/* 1 from an owner change until TurnCtrl_Output_Latched() closes its sample */
+uint8_t            TurnCtrl_Latency_Pending(void);
+/* Lamp outputs were latched at now_us; closes a pending latency sample */
+void               TurnCtrl_Output_Latched(uint64_t now_us);
+void               TurnCtrl_Get_Latency(turn_latency_t *out);
+void               TurnCtrl_Reset_Latency(void);
+
+#endif /* TURN_CTRL_H */
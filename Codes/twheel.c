@@ -0,0 +1,439 @@
+/*
+ * File: twheel.c
+ * Purpose: Three-level hashed timing wheel over a fixed node pool.
+ * Notes: Level 0 holds the timers due in the current and the next round,
+ *        indexed by expiry tick, so a level-0 slot only ever holds timers
+ *        due on exactly that tick. Level 1 holds the timers due in the
+ *        current and the next epoch by round, level 2 later ones by epoch.
+ *        During each round the next round's level-1 slot is moved down to
+ *        level 0, and during each epoch the next epoch's level-2 slot to
+ *        level 1, TWHEEL_CASCADE_STEP nodes per tick. Start never places a
+ *        timer on a slot being moved, so both are empty before they fall
+ *        due; if not (more nodes than steps), the rest is moved then and
+ *        counted in twheel_late.
+ *        Wheel time only advances in TWheel_Tick(). The clock callback runs
+ *        every tick up to the current time, jumping over ticks that fire
+ *        nothing and move nothing, and arms the swtimer for the next one.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "twheel.h"
+#include "swtimer.h"
+#include "clock_plan.h"
+#include "critical.h"
+
+#define TWHEEL_NIL                        (0xFFFFU)
+#define TWHEEL_EPOCH_BITS                 (TWHEEL_L0_BITS + TWHEEL_LN_BITS)
+#define TWHEEL_L1_BASE                    (TWHEEL_L0_SLOTS)
+#define TWHEEL_L2_BASE                    (TWHEEL_L1_BASE + TWHEEL_L1_SLOTS)
+#define TWHEEL_FREE_LIST                  (TWHEEL_L2_BASE + TWHEEL_L2_SLOTS)
+#define TWHEEL_NUM_LISTS                  (TWHEEL_FREE_LIST + 1UL)
+#define TWHEEL_MAP_WORDS                  (TWHEEL_L0_SLOTS / 32UL)
+#define TWHEEL_TC_PER_TICK                ((uint32_t)TWHEEL_TICK_MS * CLOCK_PLAN_TIMER0_TICKS_PER_MS)
+
+#if (TWHEEL_POOL_SIZE >= TWHEEL_NIL)
+#error "twheel: pool size must fit a 16-bit index"
+#endif
+
+typedef struct
+{
+    uint16_t    next;
+    uint16_t    prev;
+    uint16_t    list;      /* slot list (or free list) this node is on */
+    uint16_t    gen;       /* bumped on release, part of the handle */
+    uint32_t    expires;   /* absolute wheel tick */
+    uint32_t    period;    /* reload in ticks, 0 => one-shot */
+    twheel_cb_t cb;
+    void       *ctx;
+} twheel_node_t;
+
+static twheel_node_t twheel_pool[TWHEEL_POOL_SIZE];
+static uint16_t      twheel_heads[TWHEEL_NUM_LISTS];
+static uint32_t      twheel_map[TWHEEL_MAP_WORDS];   /* level-0 slot not empty */
+static uint32_t      twheel_now;
+static uint32_t      twheel_tc;       /* TIMER0 count at tick twheel_now */
+static uint32_t      twheel_wake;     /* tick the clock is armed for */
+static uint32_t      twheel_late;     /* nodes moved down at their deadline */
+static uint16_t      twheel_active;
+static uint8_t       twheel_ready;
+static swtimer_t     twheel_clock;
+
+static void twheel_clock_cb(void *ctx);
+
+static void twheel_link(uint16_t list, uint16_t i)
+{
+    uint16_t head = twheel_heads[list];
+
+    twheel_pool[i].list = list;
+    twheel_pool[i].prev = TWHEEL_NIL;
+    twheel_pool[i].next = head;
+    if (head != TWHEEL_NIL)
+    {
+        twheel_pool[head].prev = i;
+    }
+    twheel_heads[list] = i;
+    if (list < TWHEEL_L0_SLOTS)
+    {
+        twheel_map[list >> 5] |= (1UL << (list & 31U));
+    }
+}
+
+static void twheel_unlink(uint16_t i)
+{
+    twheel_node_t *n = &twheel_pool[i];
+
+    if (n->prev != TWHEEL_NIL)
+    {
+        twheel_pool[n->prev].next = n->next;
+    }
+    else
+    {
+        twheel_heads[n->list] = n->next;
+    }
+    if (n->next != TWHEEL_NIL)
+    {
+        twheel_pool[n->next].prev = n->prev;
+    }
+    if ((n->list < TWHEEL_L0_SLOTS) && (twheel_heads[n->list] == TWHEEL_NIL))
+    {
+        twheel_map[n->list >> 5] &= ~(1UL << (n->list & 31U));
+    }
+}
+
+/* Hang a node on its slot: rounds and epochs ahead of the current ones */
+static void twheel_place(uint16_t i)
+{
+    uint32_t expires = twheel_pool[i].expires;
+    uint32_t rounds  = (expires - (twheel_now & ~(TWHEEL_ROUND_TICKS - 1UL))) >> TWHEEL_L0_BITS;
+    uint32_t epochs  = (expires - (twheel_now & ~(TWHEEL_EPOCH_TICKS - 1UL))) >> TWHEEL_EPOCH_BITS;
+    uint16_t list;
+
+    if (rounds <= 1U)
+    {
+        list = (uint16_t)(expires & (TWHEEL_L0_SLOTS - 1UL));
+    }
+    else if (epochs <= 1U)
+    {
+        list = (uint16_t)(TWHEEL_L1_BASE + ((expires >> TWHEEL_L0_BITS) & (TWHEEL_L1_SLOTS - 1UL)));
+    }
+    else
+    {
+        list = (uint16_t)(TWHEEL_L2_BASE + ((expires >> TWHEEL_EPOCH_BITS) & (TWHEEL_L2_SLOTS - 1UL)));
+    }
+    twheel_link(list, i);
+}
+
+static void twheel_release(uint16_t i)
+{
+    twheel_pool[i].gen++;
+    twheel_link((uint16_t)TWHEEL_FREE_LIST, i);
+    twheel_active--;
+    if (twheel_active == 0U)
+    {
+        SwTimer_Stop(&twheel_clock); /* nothing to time: stop interrupting */
+    }
+}
+
+/* Slots being moved down during the current round and epoch */
+static uint16_t twheel_l1_next(void)
+{
+    return (uint16_t)(TWHEEL_L1_BASE + (((twheel_now >> TWHEEL_L0_BITS) + 1UL) & (TWHEEL_L1_SLOTS - 1UL)));
+}
+
+static uint16_t twheel_l2_next(void)
+{
+    return (uint16_t)(TWHEEL_L2_BASE + (((twheel_now >> TWHEEL_EPOCH_BITS) + 1UL) & (TWHEEL_L2_SLOTS - 1UL)));
+}
+
+/* Move up to max nodes of an upper-level slot one level down or more.
+   Interrupts masked */
+static void twheel_cascade(uint16_t list, uint32_t max)
+{
+    while ((max != 0U) && (twheel_heads[list] != TWHEEL_NIL))
+    {
+        uint16_t i = twheel_heads[list];
+        twheel_unlink(i);
+        twheel_place(i);
+        max--;
+    }
+}
+
+/* A slot fell due before it was moved: move the rest, one node per
+   masked section */
+static void twheel_cascade_all(uint16_t list)
+{
+    uint32_t primask;
+
+    for (;;)
+    {
+        primask = Critical_Enter();
+        if (twheel_heads[list] == TWHEEL_NIL)
+        {
+            Critical_Exit(primask);
+            break;
+        }
+        twheel_cascade(list, 1U);
+        twheel_late++;
+        Critical_Exit(primask);
+    }
+}
+
+/* First tick after now with work: a due slot, nodes to move down, or the
+   next round. Interrupts masked */
+static uint32_t twheel_next_work(void)
+{
+    uint32_t left = TWHEEL_ROUND_TICKS - (twheel_now & (TWHEEL_ROUND_TICKS - 1UL));
+    uint32_t d    = 1U;
+
+    if ((twheel_heads[twheel_l1_next()] != TWHEEL_NIL) || (twheel_heads[twheel_l2_next()] != TWHEEL_NIL))
+    {
+        return twheel_now + 1U;
+    }
+    while (d < left)
+    {
+        uint32_t s = (twheel_now + d) & (TWHEEL_L0_SLOTS - 1UL);
+        uint32_t w = twheel_map[s >> 5] >> (s & 31U);
+
+        if (w == 0U)
+        {
+            d += 32U - (s & 31U);
+            continue;
+        }
+        while ((w & 1U) == 0U)
+        {
+            w >>= 1;
+            d++;
+        }
+        break;
+    }
+    return twheel_now + ((d < left) ? d : left);
+}
+
+/* Whole ticks the wheel is behind TIMER0. Interrupts masked */
+static uint32_t twheel_lag(void)
+{
+    int32_t counts = (int32_t)(SwTimer_Now() - twheel_tc);
+
+    return (counts > 0) ? ((uint32_t)counts / TWHEEL_TC_PER_TICK) : 0U;
+}
+
+/* Interrupts masked */
+static void twheel_arm(uint32_t tick)
+{
+    twheel_wake = tick;
+    (void)SwTimer_Start_At(&twheel_clock, twheel_tc + ((tick - twheel_now) * TWHEEL_TC_PER_TICK),
+                           twheel_clock_cb, NULL);
+}
+
+/* Catch up with TIMER0, ticking only where there is work, then sleep
+   until the next such tick */
+static void twheel_clock_cb(void *ctx)
+{
+    uint32_t primask;
+    uint32_t target;
+    uint32_t next;
+
+    (void)ctx;
+    primask = Critical_Enter();
+    target  = twheel_now + twheel_lag();
+    Critical_Exit(primask);
+
+    for (;;)
+    {
+        primask = Critical_Enter();
+        if ((twheel_active == 0U) || (twheel_now == target))
+        {
+            Critical_Exit(primask);
+            break;
+        }
+        next = twheel_next_work();
+        if ((int32_t)(next - target) > 0)
+        {
+            next = target + 1U;   /* nothing due up to target */
+        }
+        twheel_tc  += (next - 1U - twheel_now) * TWHEEL_TC_PER_TICK;
+        twheel_now  = next - 1U;
+        Critical_Exit(primask);
+
+        if (twheel_now != target)
+        {
+            TWheel_Tick();
+        }
+    }
+
+    primask = Critical_Enter();
+    if (twheel_active != 0U)
+    {
+        twheel_arm(twheel_next_work());
+    }
+    Critical_Exit(primask);
+}
+
+void TWheel_Init(void)
+{
+    uint32_t primask = Critical_Enter();
+    uint16_t i;
+
+    SwTimer_Stop(&twheel_clock);
+    for (i = 0U; i < TWHEEL_NUM_LISTS; i++)
+    {
+        twheel_heads[i] = TWHEEL_NIL;
+    }
+    for (i = 0U; i < TWHEEL_MAP_WORDS; i++)
+    {
+        twheel_map[i] = 0U;
+    }
+    for (i = 0U; i < TWHEEL_POOL_SIZE; i++)
+    {
+        twheel_pool[i].gen = 0U;
+        twheel_link((uint16_t)TWHEEL_FREE_LIST, i);
+    }
+    twheel_now    = 0U;
+    twheel_tc     = 0U;
+    twheel_wake   = 0U;
+    twheel_late   = 0U;
+    twheel_active = 0U;
+    twheel_ready  = 1U;
+    Critical_Exit(primask);
+}
+
+twheel_handle_t TWheel_Start(uint32_t first_ms, uint32_t period_ms, twheel_cb_t cb, void *ctx)
+{
+    uint32_t first  = first_ms / TWHEEL_TICK_MS;
+    uint32_t period = period_ms / TWHEEL_TICK_MS;
+    twheel_handle_t handle = TWHEEL_INVALID_HANDLE;
+    uint32_t primask;
+    uint32_t lag;
+    uint16_t i;
+
+    /* Before TWheel_Init() the zeroed list heads are not empty lists */
+    if ((twheel_ready == 0U) || (cb == NULL) || (first > TWHEEL_MAX_DELAY_TICKS) ||
+        (period > TWHEEL_MAX_DELAY_TICKS) || ((period_ms != 0U) && (period == 0U)))
+    {
+        return TWHEEL_INVALID_HANDLE;
+    }
+    if (first == 0U)
+    {
+        first = 1U; /* earliest is the next tick */
+    }
+
+    primask = Critical_Enter();
+    if (twheel_active == 0U)
+    {
+        twheel_tc = SwTimer_Now(); /* the wheel stood still: now is now */
+    }
+    lag = twheel_lag();           /* clock ISR pending: count from TIMER0 time */
+    i   = twheel_heads[TWHEEL_FREE_LIST];
+    if ((i != TWHEEL_NIL) && ((first + lag) <= TWHEEL_MAX_DELAY_TICKS))
+    {
+        twheel_unlink(i);
+        twheel_pool[i].expires = twheel_now + lag + first;
+        twheel_pool[i].period  = period;
+        twheel_pool[i].cb      = cb;
+        twheel_pool[i].ctx     = ctx;
+        twheel_place(i);
+
+        twheel_active++;
+        if ((twheel_active == 1U) || ((int32_t)(twheel_pool[i].expires - twheel_wake) < 0))
+        {
+            twheel_arm(twheel_next_work());
+        }
+        handle = ((twheel_handle_t)twheel_pool[i].gen << 16) | i;
+    }
+    Critical_Exit(primask);
+
+    return handle;
+}
+
+void TWheel_Stop(twheel_handle_t handle)
+{
+    uint16_t i   = (uint16_t)(handle & 0xFFFFUL);
+    uint16_t gen = (uint16_t)(handle >> 16);
+    uint32_t primask;
+
+    if ((twheel_ready == 0U) || (i >= TWHEEL_POOL_SIZE))
+    {
+        return;
+    }
+
+    primask = Critical_Enter();
+    if ((twheel_pool[i].gen == gen) && (twheel_pool[i].list != TWHEEL_FREE_LIST))
+    {
+        twheel_unlink(i);
+        twheel_release(i);
+    }
+    Critical_Exit(primask);
+}
+
+uint16_t TWheel_Active_Count(void)
+{
+    return twheel_active;
+}
+
+void TWheel_Tick(void)
+{
+    uint32_t primask;
+    uint32_t round;
+    uint16_t slot;
+
+    if (twheel_ready == 0U)
+    {
+        return;
+    }
+
+    primask = Critical_Enter();
+    twheel_now++;
+    twheel_tc += TWHEEL_TC_PER_TICK;
+    round = twheel_now >> TWHEEL_L0_BITS;
+    slot  = (uint16_t)(twheel_now & (TWHEEL_L0_SLOTS - 1UL));
+    Critical_Exit(primask);
+
+    /* Normally already empty: the last round of an epoch needs the next
+       epoch's timers, and every round its own */
+    if ((twheel_now & (TWHEEL_ROUND_TICKS - 1UL)) == 0U)
+    {
+        if ((round & ((1UL << TWHEEL_LN_BITS) - 1UL)) == ((1UL << TWHEEL_LN_BITS) - 1UL))
+        {
+            twheel_cascade_all(twheel_l2_next());
+        }
+        twheel_cascade_all((uint16_t)(TWHEEL_L1_BASE + (round & (TWHEEL_L1_SLOTS - 1UL))));
+    }
+
+    /* Bounded step of moving the next epoch and round down */
+    primask = Critical_Enter();
+    twheel_cascade(twheel_l2_next(), TWHEEL_CASCADE_STEP);
+    twheel_cascade(twheel_l1_next(), TWHEEL_CASCADE_STEP);
+    Critical_Exit(primask);
+
+    /* Everything on the current level-0 slot is due exactly now */
+    for (;;)
+    {
+        twheel_cb_t cb;
+        void       *ctx;
+        uint16_t    i;
+
+        primask = Critical_Enter();
+        i = twheel_heads[slot];
+        if (i == TWHEEL_NIL)
+        {
+            Critical_Exit(primask);
+            break;
+        }
+        twheel_unlink(i);
+        cb  = twheel_pool[i].cb;
+        ctx = twheel_pool[i].ctx;
+        if (twheel_pool[i].period != 0U)
+        {
+            twheel_pool[i].expires += twheel_pool[i].period;
+            twheel_place(i);
+        }
+        else
+        {
+            twheel_release(i);
+        }
+        Critical_Exit(primask);
+
+        cb(ctx);
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * File: twheel.h
+ * Purpose: Hierarchical timing wheel for many periodic timers (MISRA C:2012 aligned)
+ *
+ * Timers come from a fixed pool and hang in doubly linked slot lists, so
+ * start, stop and expire are O(1). Three levels cover 1 ms resolution up to
+ * TWHEEL_MAX_DELAY_TICKS. Timers move down a level ahead of time, at most
+ * TWHEEL_CASCADE_STEP per level and tick, so the cost of a tick does not
+ * depend on how many timers are running, only on how many fire.
+ *
+ * The wheel is clocked by one swtimer, armed only for the next tick that
+ * fires a timer or has timers to move down, and at least once per round
+ * (TWHEEL_ROUND_TICKS); it stops while no wheel timer is active. Callbacks
+ * run in TIMER0 ISR context.
+ */
+
+#ifndef TWHEEL_H
+#define TWHEEL_H
+
+#include <stdint.h>
+
+/* Wheel resolution */
+#define TWHEEL_TICK_MS                    (1U)
+
+/* Timer node pool size */
+#ifndef TWHEEL_POOL_SIZE
+#define TWHEEL_POOL_SIZE                  (64U)
+#endif
+
+/* Wheel geometry: a round is TWHEEL_ROUND_TICKS ticks and an epoch
+   2^TWHEEL_LN_BITS rounds. Level 0 has a slot per tick for two rounds and
+   level 1 a slot per round for two epochs, so the next round (epoch) can
+   be filled while the current one runs; level 2 has a slot per epoch */
+#define TWHEEL_L0_BITS                    (8U)
+#define TWHEEL_LN_BITS                    (6U)
+#define TWHEEL_ROUND_TICKS                (1UL << TWHEEL_L0_BITS)
+#define TWHEEL_EPOCH_TICKS                (TWHEEL_ROUND_TICKS << TWHEEL_LN_BITS)
+#define TWHEEL_L0_SLOTS                   (2UL * TWHEEL_ROUND_TICKS)
+#define TWHEEL_L1_SLOTS                   (2UL << TWHEEL_LN_BITS)
+#define TWHEEL_L2_SLOTS                   (1UL << TWHEEL_LN_BITS)
+#define TWHEEL_MAX_DELAY_TICKS            ((TWHEEL_L2_SLOTS - 1UL) * TWHEEL_EPOCH_TICKS)
+
+/* Timers moved down per level and tick. A slot holding more than this per
+   tick of its round (epoch) has the rest moved when it falls due */
+#define TWHEEL_CASCADE_STEP               (4U)
+
+/* Handle of a running timer: pool index in the low half, node generation
+   in the high half so a stale handle can never stop a recycled node */
+typedef uint32_t twheel_handle_t;
+#define TWHEEL_INVALID_HANDLE             (0xFFFFFFFFUL)
+
+typedef void (*twheel_cb_t)(void *ctx);
+
+/* Public API */
+/* Call once after SwTimer_Init() and before any other wheel call */
+void            TWheel_Init(void);
+/* Allocate and arm: first expiry after first_ms, then every period_ms
+   (0 => one-shot, node returns to the pool when it fires).
+   Returns TWHEEL_INVALID_HANDLE before TWheel_Init(), if the pool is empty
+   or if a delay is too long */
+twheel_handle_t TWheel_Start(uint32_t first_ms, uint32_t period_ms, twheel_cb_t cb, void *ctx);
+/* Disarm and release; a stale handle (expired one-shot) is ignored */
+void            TWheel_Stop(twheel_handle_t handle);
+uint16_t        TWheel_Active_Count(void);
+/* Advance the wheel by one tick: cascade steps, then the due callbacks.
+   The clock does this for every tick with work; exposed for tests */
+void            TWheel_Tick(void);
+
+#endif /* TWHEEL_H */
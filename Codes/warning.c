@@ -0,0 +1,86 @@
+/*
+ * File: warning.c
+ * Purpose: Warning lamp rules with a Q16 fuel filter and integer hysteresis.
+ * Notes: The filter state keeps 16 fraction bits of a percent, so a 0.02
+ *        step is never lost to truncation: the difference is scaled by
+ *        alpha with one 32x32->64 multiply (SMULL on the M3) and rounded to
+ *        nearest. The state stays within the range of its inputs, so it
+ *        cannot overflow.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "warning.h"
+
+static int32_t warning_fuel_q16;     /* filtered fuel, Q16 percent */
+static uint8_t warning_low_fuel;     /* hysteresis latch */
+static uint8_t warning_lamps;
+
+void Warning_Init(void)
+{
+    warning_fuel_q16 = (int32_t)WARNING_FUEL_FULL_Q16;
+    warning_low_fuel = 0U;
+    warning_lamps    = 0U;
+}
+
+/* y += alpha * (x - y), rounded to nearest */
+static int32_t warning_iir(int32_t y, int32_t x)
+{
+    int64_t step = ((int64_t)(x - y) * (int64_t)WARNING_FUEL_ALPHA_Q16) + 32768;
+
+    return y + (int32_t)(step >> 16);
+}
+
+uint8_t Warning_Tick(const warning_in_t *in)
+{
+    uint32_t fuel;
+    uint8_t  lamps = 0U;
+
+    if (in == NULL)
+    {
+        return warning_lamps;
+    }
+
+    fuel = (in->fuel_pct_q16 > WARNING_FUEL_FULL_Q16) ? WARNING_FUEL_FULL_Q16 : in->fuel_pct_q16;
+    warning_fuel_q16 = warning_iir(warning_fuel_q16, (int32_t)fuel);
+
+    if (warning_low_fuel == 0U)
+    {
+        if (warning_fuel_q16 <= (int32_t)WARNING_FUEL_ON_Q16)
+        {
+            warning_low_fuel = 1U;
+        }
+    }
+    else
+    {
+        if (warning_fuel_q16 >= (int32_t)WARNING_FUEL_OFF_Q16)
+        {
+            warning_low_fuel = 0U;
+        }
+    }
+
+    if (in->seatbelt_buckled == 0U)
+    {
+        lamps |= (uint8_t)WARNING_LAMP_SEATBELT;
+    }
+    if (in->service_due != 0U)
+    {
+        lamps |= (uint8_t)WARNING_LAMP_SERVICE;
+    }
+    if (warning_low_fuel != 0U)
+    {
+        lamps |= (uint8_t)WARNING_LAMP_LOW_FUEL;
+    }
+    warning_lamps = lamps;
+    return lamps;
+}
+
+uint8_t Warning_Lamps(void)
+{
+    return warning_lamps;
+}
+
+uint32_t Warning_Fuel_Q16(void)
+{
+    return (uint32_t)warning_fuel_q16;
+}
@@ -0,0 +1,62 @@
+/*
+ * File: warning.h
+ * Purpose: Seatbelt, service and low-fuel warning lamps in fixed point (MISRA C:2012 aligned)
+ *
+ * Implements Plans/Indicators logic/pseudocode_warning.c without float: the
+ * LPC1768 has no FPU and soft-float would cost hundreds of cycles per
+ * sample. Fuel is a percentage in Q16 (100 % = 100 << 16). It is smoothed
+ * by a first-order IIR with alpha = 1311 / 65536 (0.02, ~250 ms time
+ * constant at the 5 ms tick) and compared against integer thresholds:
+ * the low-fuel lamp latches ON at or below 15 % and OFF at or above 18 %.
+ * The filter starts at 100 % so the lamp cannot flash at power-up.
+ *
+ * Against the float pseudocode the filtered value stays within
+ * WARNING_FUEL_TOL_Q16 (sim_warning.c); the lamps match it wherever the
+ * float value is not within that tolerance of a threshold.
+ */
+
+#ifndef WARNING_H
+#define WARNING_H
+
+#include <stdint.h>
+
+/* Evaluation period, shared with the turn arbitration */
+#define WARNING_TICK_MS                   (5U)
+
+/* Whole percent to Q16 */
+#define WARNING_PCT_Q16(pct)              ((uint32_t)(pct) << 16)
+
+#define WARNING_FUEL_FULL_Q16             WARNING_PCT_Q16(100U)
+#define WARNING_FUEL_ON_Q16               WARNING_PCT_Q16(15U)   /* lamp ON at or below */
+#define WARNING_FUEL_OFF_Q16              WARNING_PCT_Q16(18U)   /* lamp OFF at or above */
+
+/* IIR coefficient in Q16: round(0.02 * 65536) */
+#define WARNING_FUEL_ALPHA_Q16            (1311U)
+
+/* Largest difference from the float reference: 0.01 % */
+#define WARNING_FUEL_TOL_Q16              (655U)
+
+/* Lamp bits returned by Warning_Tick() */
+#define WARNING_LAMP_SEATBELT             (1U << 0)
+#define WARNING_LAMP_SERVICE              (1U << 1)
+#define WARNING_LAMP_LOW_FUEL             (1U << 2)
+
+/* Debounced inputs for one tick */
+typedef struct
+{
+    uint8_t  seatbelt_buckled;   /* 1 = buckled */
+    uint8_t  service_due;        /* 1 = service due */
+    uint32_t fuel_pct_q16;       /* raw fuel level, 0..WARNING_FUEL_FULL_Q16 */
+} warning_in_t;
+
+/* Public API (main context) */
+/* All lamps off, filter at full */
+void     Warning_Init(void);
+/* Filter, apply hysteresis and return the WARNING_LAMP_* bits that are on.
+   Call every WARNING_TICK_MS */
+uint8_t  Warning_Tick(const warning_in_t *in);
+uint8_t  Warning_Lamps(void);
+/* Filtered fuel level, Q16 percent */
+uint32_t Warning_Fuel_Q16(void);
+
+#endif /* WARNING_H */